@@ -2,6 +2,8 @@
 #define __REPLACE_HEADER__
 
 #include <memory>
+#include <string>
+#include <cstdint>
 
 namespace odb {
   class dbDatabase;
@@ -35,6 +37,21 @@ class Replace
     void doInitialPlace();
     void doNesterovPlace();
 
+    // heap bytes of a placer subsystem (capacity based);
+    // placer_base, nesterov_base, bin_grid, fft, nesterov_place,
+    // initial_place and total (sum of them).
+    // large_array is the part of them in large arrays
+    // (See setHugePageMode), and huge_page is the bytes
+    // backed by transparent huge pages.
+    // peak_rss is the peak RSS of the process.
+    // returns -1 for unknown names.
+    int64_t getMemoryBytes(const std::string& subsystem);
+    void reportMemory(int verbose = 0);
+
+    // dump the placer's model for replace_bench.
+    // returns false on I/O errors.
+    bool writeSnapshot(const std::string& fileName);
+
     // Initial Place param settings
     void setInitialPlaceMaxIter(int iter);
     void setInitialPlaceMinDiffLength(int length);
@@ -42,6 +59,11 @@ class Replace
     void setInitialPlaceMaxFanout(int fanout);
     void setInitialPlaceNetWeightScale(float scale);
 
+    // solver : cg / bicgstab
+    // precond : none / jacobi / ichol
+    void setInitialPlaceSolver(const std::string& solver);
+    void setInitialPlacePrecond(const std::string& precond);
+
     void setNesterovPlaceMaxIter(int iter);
 
     void setBinGridCntX(int binGridCntX);
@@ -54,12 +76,36 @@ class Replace
     void setMinPhiCoef(float minPhiCoef);
     void setMaxPhiCoef(float maxPhiCoef);
 
+    // start with fillers 2^level x 2^level times larger
+    // and split them as overflow drops. 0 disables it.
+    void setCoarseFillerLevel(int level);
+
+    // sort cells/pins/nets by location for cache locality
+    // before Nesterov place, and again every interval iterations
+    // if interval > 0.
+    void setLocalityOrder(bool mode);
+    void setLocalityOrderInterval(int interval);
+
+    // back large arrays (Nesterov vectors, bins, FFT buffers)
+    // with transparent huge pages, and first-touch them by
+    // the OpenMP threads that work on them (NUMA placement).
+    void setHugePageMode(bool mode);
+    void setFirstTouchMode(bool mode);
+
     // HPWL: half-parameter wire length.
     void setReferenceHpwl(float deltaHpwl);
 
     void setIncrementalPlaceMode(bool mode);
     void setVerboseLevel(int verbose);
 
+    // write per-phase runtimes as JSON after Nesterov place.
+    // empty fileName disables it.
+    void setProfileJsonFile(const std::string& fileName);
+
+    // write per-iteration Nesterov metrics (JSON Lines, or CSV
+    // for *.csv) while placing. empty fileName disables it.
+    void setMetricsFile(const std::string& fileName);
+
   private:
     odb::dbDatabase* db_;
     sta::dbSta* sta_;
@@ -77,6 +123,8 @@ class Replace
     int initialPlaceMaxSolverIter_;
     int initialPlaceMaxFanout_;
     float initialPlaceNetWeightScale_;
+    std::string initialPlaceSolver_;
+    std::string initialPlacePrecond_;
 
     int nesterovPlaceMaxIter_;
     int binGridCntX_;
@@ -88,9 +136,18 @@ class Replace
     float minPhiCoef_;
     float maxPhiCoef_;
     float referenceHpwl_;
+    int coarseFillerLevel_;
+    bool localityOrder_;
+    int localityOrderInterval_;
+    bool hugePageMode_;
+    bool firstTouchMode_;
 
     bool incrementalPlaceMode_;
     int verbose_;
+    std::string profileJsonFile_;
+    std::string metricsFile_;
+
+    void initPlacerBase();
 };
 }
 
@@ -0,0 +1,1065 @@
+#include "bookshelf.h"
+#include "logger.h"
+#include "parallel.h"
+
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <climits>
+#include <strings.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace replace {
+
+using namespace std;
+
+// chunks smaller than this are not worth a thread
+static const size_t minChunkSize = 1 << 20;
+
+////////////////////////////////////////////////////////
+// MappedFile : read-only memory-mapped input file
+
+class MappedFile {
+public:
+  MappedFile();
+  ~MappedFile();
+
+  bool open(const string& fileName);
+
+  const char* begin() const { return buf_; }
+  const char* end() const { return buf_ + size_; }
+  size_t size() const { return size_; }
+
+private:
+  char* buf_;
+  size_t size_;
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+};
+
+MappedFile::MappedFile()
+  : buf_(nullptr), size_(0) {}
+
+MappedFile::~MappedFile() {
+  if( buf_ ) {
+    munmap(buf_, size_);
+  }
+}
+
+bool
+MappedFile::open(const string& fileName) {
+  int fd = ::open(fileName.c_str(), O_RDONLY);
+  if( fd < 0 ) {
+    return false;
+  }
+
+  struct stat fileStat;
+  if( fstat(fd, &fileStat) != 0 ) {
+    close(fd);
+    return false;
+  }
+
+  size_ = fileStat.st_size;
+  if( size_ == 0 ) {
+    close(fd);
+    return true;
+  }
+
+  void* buf = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if( buf == MAP_FAILED ) {
+    size_ = 0;
+    return false;
+  }
+  // the whole file is scanned once from the front
+  madvise(buf, size_, MADV_SEQUENTIAL);
+  buf_ = static_cast<char*>(buf);
+  return true;
+}
+
+////////////////////////////////////////////////////////
+// Line tokenizer
+
+class Token {
+public:
+  const char* begin;
+  const char* end;
+
+  bool equals(const char* str) const;
+  string str() const { return string(begin, end); }
+};
+
+bool
+Token::equals(const char* str) const {
+  const size_t len = strlen(str);
+  return static_cast<size_t>(end - begin) == len
+    && strncasecmp(begin, str, len) == 0;
+}
+
+static const char*
+getNextLine(const char* cur, const char* end) {
+  const char* newLine
+    = static_cast<const char*>(memchr(cur, '\n', end - cur));
+  return (newLine)? newLine + 1 : end;
+}
+
+// split a line into whitespace separated tokens.
+// '#' starts a comment and ':' is always a token by itself.
+static void
+tokenize(const char* begin, const char* end, vector<Token>& tokens) {
+  tokens.clear();
+  const char* cur = begin;
+  while( cur < end ) {
+    const char c = *cur;
+    if( c == '#' ) {
+      break;
+    }
+    if( isspace(static_cast<unsigned char>(c)) ) {
+      cur++;
+      continue;
+    }
+    Token token;
+    token.begin = cur;
+    if( c == ':' ) {
+      cur++;
+    }
+    else {
+      while( cur < end && *cur != ':' && *cur != '#'
+          && !isspace(static_cast<unsigned char>(*cur)) ) {
+        cur++;
+      }
+    }
+    token.end = cur;
+    tokens.push_back(token);
+  }
+}
+
+// the mapped buffer is not null terminated
+static bool
+getDouble(const Token& token, double& val) {
+  char buf[64];
+  const size_t len = token.end - token.begin;
+  if( len == 0 || len >= sizeof(buf) ) {
+    return false;
+  }
+  memcpy(buf, token.begin, len);
+  buf[len] = '\0';
+
+  char* endPtr = nullptr;
+  val = strtod(buf, &endPtr);
+  return *endPtr == '\0';
+}
+
+static bool
+getInt(const Token& token, int& val) {
+  double dVal = 0;
+  if( !getDouble(token, dVal) ) {
+    return false;
+  }
+  val = static_cast<int>(dVal);
+  return true;
+}
+
+static int
+getScaled(double val, int scale) {
+  return static_cast<int>(lround(val * scale));
+}
+
+static bool
+isHeaderLine(const vector<Token>& tokens) {
+  return tokens[0].equals("UCLA");
+}
+
+static bool
+isNetDegreeLine(const char* begin, const char* end) {
+  static const char netDegree[] = "NetDegree";
+  const size_t len = sizeof(netDegree) - 1;
+  while( begin < end && (*begin == ' ' || *begin == '\t') ) {
+    begin++;
+  }
+  return static_cast<size_t>(end - begin) >= len
+    && strncasecmp(begin, netDegree, len) == 0;
+}
+
+// split [begin, end) on line boundaries into chunks of
+// similar size for parallel parsing.
+// With isChunkStart, every chunk starts on the line it accepts
+// (e.g. "NetDegree" lines, so that nets are not cut).
+//
+// Returns chunk boundaries; chunk i is [bounds[i], bounds[i+1]).
+static vector<const char*>
+getChunkBounds(const char* begin, const char* end,
+    bool (*isChunkStart)(const char*, const char*)) {
+  const size_t size = end - begin;
+  const size_t chunkCnt = max(static_cast<size_t>(1),
+      min(static_cast<size_t>(getMaxThreads() * 4),
+        size / minChunkSize));
+
+  vector<const char*> bounds;
+  bounds.push_back(begin);
+  for(size_t i=1; i<chunkCnt; i++) {
+    const char* cur = max(begin + size * i / chunkCnt, bounds.back());
+    if( cur > begin && cur[-1] != '\n' ) {
+      cur = getNextLine(cur, end);
+    }
+    if( isChunkStart ) {
+      while( cur < end
+          && !isChunkStart(cur, getNextLine(cur, end)) ) {
+        cur = getNextLine(cur, end);
+      }
+    }
+    bounds.push_back(cur);
+  }
+  bounds.push_back(end);
+  return bounds;
+}
+
+static string
+getLine(const char* begin, const char* end) {
+  const char* lineEnd = getNextLine(begin, end);
+  while( lineEnd > begin
+      && (lineEnd[-1] == '\n' || lineEnd[-1] == '\r') ) {
+    lineEnd--;
+  }
+  return string(begin, lineEnd);
+}
+
+////////////////////////////////////////////////////////
+// Orientations
+
+enum class Orient {
+  N, S, W, E, FN, FS, FW, FE
+};
+
+static const char* orientNames[] = {
+  "N", "S", "W", "E", "FN", "FS", "FW", "FE"
+};
+
+static bool
+getOrient(const Token& token, Orient& orient) {
+  for(int i=0; i<8; i++) {
+    if( token.equals(orientNames[i]) ) {
+      orient = static_cast<Orient>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool
+isRotated(Orient orient) {
+  return orient == Orient::W || orient == Orient::E
+    || orient == Orient::FW || orient == Orient::FE;
+}
+
+// pin offset from the node center in the given orientation
+static void
+getOrientOffset(Orient orient, double& x, double& y) {
+  const double ox = x, oy = y;
+  switch(orient) {
+    case Orient::N:  x =  ox; y =  oy; break;
+    case Orient::S:  x = -ox; y = -oy; break;
+    case Orient::W:  x = -oy; y =  ox; break;
+    case Orient::E:  x =  oy; y = -ox; break;
+    case Orient::FN: x = -ox; y =  oy; break;
+    case Orient::FS: x =  ox; y = -oy; break;
+    case Orient::FW: x = -oy; y = -ox; break;
+    case Orient::FE: x =  oy; y =  ox; break;
+  }
+}
+
+////////////////////////////////////////////////////////
+// Per-chunk parse results
+
+class NodeData {
+public:
+  string name;
+  double width;
+  double height;
+  bool isTerminal;
+  bool isNonImage;
+};
+
+class PlData {
+public:
+  int node;
+  double x;
+  double y;
+  Orient orient;
+  bool isFixed;
+  bool isNonImage;
+};
+
+class NetsChunk {
+public:
+  // PinData::net is chunk-local until merged
+  vector<PlacerBaseData::PinData> pins;
+  int netCnt;
+  string error;
+
+  NetsChunk() : netCnt(0) {}
+};
+
+// node locations after .pl parsing
+class NodeLoc {
+public:
+  double x;
+  double y;
+  Orient orient;
+  bool isFixed;
+  bool isNonImage;
+
+  NodeLoc() : x(0), y(0), orient(Orient::N),
+    isFixed(false), isNonImage(false) {}
+};
+
+typedef unordered_map<string, int> NodeMap;
+
+static bool
+parseNodesChunk(const char* begin, const char* end,
+    vector<NodeData>& nodes, string& error) {
+  vector<Token> tokens;
+  for(const char* cur = begin; cur < end; cur = getNextLine(cur, end)) {
+    tokenize(cur, getNextLine(cur, end), tokens);
+    if( tokens.empty() || isHeaderLine(tokens)
+        || tokens[0].equals("NumNodes")
+        || tokens[0].equals("NumTerminals") ) {
+      continue;
+    }
+
+    NodeData node;
+    if( tokens.size() < 3
+        || !getDouble(tokens[1], node.width)
+        || !getDouble(tokens[2], node.height) ) {
+      error = "Invalid node: " + getLine(cur, end);
+      return false;
+    }
+    node.name = tokens[0].str();
+    node.isTerminal = node.isNonImage = false;
+    if( tokens.size() >= 4 ) {
+      node.isNonImage = tokens[3].equals("terminal_NI");
+      node.isTerminal = node.isNonImage || tokens[3].equals("terminal");
+    }
+    nodes.push_back(node);
+  }
+  return true;
+}
+
+static bool
+parsePlChunk(const char* begin, const char* end,
+    const NodeMap& nodeMap,
+    vector<PlData>& pls, string& error) {
+  vector<Token> tokens;
+  for(const char* cur = begin; cur < end; cur = getNextLine(cur, end)) {
+    tokenize(cur, getNextLine(cur, end), tokens);
+    if( tokens.empty() || isHeaderLine(tokens) ) {
+      continue;
+    }
+
+    PlData pl;
+    if( tokens.size() < 3
+        || !getDouble(tokens[1], pl.x)
+        || !getDouble(tokens[2], pl.y) ) {
+      error = "Invalid placement: " + getLine(cur, end);
+      return false;
+    }
+
+    auto nodePtr = nodeMap.find(tokens[0].str());
+    if( nodePtr == nodeMap.end() ) {
+      error = "Unknown node in .pl: " + tokens[0].str();
+      return false;
+    }
+    pl.node = nodePtr->second;
+    pl.orient = Orient::N;
+    pl.isFixed = pl.isNonImage = false;
+
+    for(size_t i=3; i<tokens.size(); i++) {
+      if( tokens[i].equals(":") ) {
+        continue;
+      }
+      if( tokens[i].equals("/FIXED") ) {
+        pl.isFixed = true;
+      }
+      else if( tokens[i].equals("/FIXED_NI") ) {
+        pl.isFixed = pl.isNonImage = true;
+      }
+      else if( !getOrient(tokens[i], pl.orient) ) {
+        error = "Invalid placement: " + getLine(cur, end);
+        return false;
+      }
+    }
+    pls.push_back(pl);
+  }
+  return true;
+}
+
+// node index -> inst index (>= 0) or -1 for terminal_NI
+class NodeIndex {
+public:
+  const NodeMap* nodeMap;
+  const vector<NodeData>* nodes;
+  const vector<NodeLoc>* locs;
+  const vector<int>* nodeToInst;
+  int scale;
+};
+
+static bool
+parseNetsChunk(const char* begin, const char* end,
+    const NodeIndex& index, NetsChunk& chunk) {
+  vector<Token> tokens;
+  for(const char* cur = begin; cur < end; cur = getNextLine(cur, end)) {
+    tokenize(cur, getNextLine(cur, end), tokens);
+    if( tokens.empty() || isHeaderLine(tokens)
+        || tokens[0].equals("NumNets")
+        || tokens[0].equals("NumPins") ) {
+      continue;
+    }
+
+    if( tokens[0].equals("NetDegree") ) {
+      chunk.netCnt++;
+      continue;
+    }
+
+    if( chunk.netCnt == 0 ) {
+      chunk.error = "Pin outside of nets: " + getLine(cur, end);
+      return false;
+    }
+
+    auto nodePtr = index.nodeMap->find(tokens[0].str());
+    if( nodePtr == index.nodeMap->end() ) {
+      chunk.error = "Unknown node in .nets: " + tokens[0].str();
+      return false;
+    }
+    const int node = nodePtr->second;
+
+    // name dir : offsetX offsetY
+    // (offsets are optional)
+    double offsetX = 0, offsetY = 0;
+    for(size_t i=1; i<tokens.size(); i++) {
+      if( tokens[i].equals(":") ) {
+        if( i+1 == tokens.size() ) {
+          break;
+        }
+        if( i+2 >= tokens.size()
+            || !getDouble(tokens[i+1], offsetX)
+            || !getDouble(tokens[i+2], offsetY) ) {
+          chunk.error = "Invalid pin: " + getLine(cur, end);
+          return false;
+        }
+        break;
+      }
+    }
+
+    const NodeLoc& loc = (*index.locs)[node];
+    getOrientOffset(loc.orient, offsetX, offsetY);
+
+    PlacerBaseData::PinData pin;
+    pin.net = chunk.netCnt - 1;
+    pin.inst = (*index.nodeToInst)[node];
+    if( pin.inst >= 0 ) {
+      pin.x = getScaled(offsetX, index.scale);
+      pin.y = getScaled(offsetY, index.scale);
+    }
+    else {
+      // IO pins keep their absolute location
+      const NodeData& nodeData = (*index.nodes)[node];
+      const bool isRotatedNode = isRotated(loc.orient);
+      const double width
+        = (isRotatedNode)? nodeData.height : nodeData.width;
+      const double height
+        = (isRotatedNode)? nodeData.width : nodeData.height;
+      pin.x = getScaled(loc.x + width / 2 + offsetX, index.scale);
+      pin.y = getScaled(loc.y + height / 2 + offsetY, index.scale);
+    }
+    chunk.pins.push_back(pin);
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////
+// Per-file readers
+
+static bool
+readAux(const string& auxFileName,
+    string& nodesFileName, string& netsFileName,
+    string& plFileName, string& sclFileName,
+    string& error) {
+  ifstream in(auxFileName);
+  if( !in.good() ) {
+    error = "Cannot open .aux file: " + auxFileName;
+    return false;
+  }
+
+  // other files are relative to .aux
+  string dirName;
+  const size_t slashPos = auxFileName.find_last_of('/');
+  if( slashPos != string::npos ) {
+    dirName = auxFileName.substr(0, slashPos + 1);
+  }
+
+  string line;
+  vector<Token> tokens;
+  while( getline(in, line) ) {
+    tokenize(line.data(), line.data() + line.size(), tokens);
+    for(auto& token : tokens) {
+      const string name = token.str();
+      const size_t dotPos = name.find_last_of('.');
+      if( dotPos == string::npos ) {
+        continue;
+      }
+      const string ext = name.substr(dotPos);
+      if( ext == ".nodes" ) {
+        nodesFileName = dirName + name;
+      }
+      else if( ext == ".nets" ) {
+        netsFileName = dirName + name;
+      }
+      else if( ext == ".pl" ) {
+        plFileName = dirName + name;
+      }
+      else if( ext == ".scl" ) {
+        sclFileName = dirName + name;
+      }
+    }
+  }
+
+  if( nodesFileName.empty() || netsFileName.empty()
+      || plFileName.empty() || sclFileName.empty() ) {
+    error = ".aux must have .nodes, .nets, .pl and .scl: " + auxFileName;
+    return false;
+  }
+  return true;
+}
+
+static bool
+readScl(const string& sclFileName, int scale,
+    PlacerBaseData& data, string& error) {
+  ifstream in(sclFileName);
+  if( !in.good() ) {
+    error = "Cannot open .scl file: " + sclFileName;
+    return false;
+  }
+
+  double coordinate = 0, height = 0, siteWidth = 0, siteSpacing = 0;
+  double subrowOrigin = 0;
+  int numSites = 0;
+
+  string line;
+  vector<Token> tokens;
+  while( getline(in, line) ) {
+    tokenize(line.data(), line.data() + line.size(), tokens);
+    if( tokens.empty() ) {
+      continue;
+    }
+
+    // key : value pairs
+    for(size_t i=0; i+2<tokens.size(); i++) {
+      if( !tokens[i+1].equals(":") ) {
+        continue;
+      }
+      const Token& key = tokens[i];
+      const Token& val = tokens[i+2];
+      bool isValid = true;
+      if( key.equals("Coordinate") ) {
+        isValid = getDouble(val, coordinate);
+      }
+      else if( key.equals("Height") ) {
+        isValid = getDouble(val, height);
+      }
+      else if( key.equals("Sitewidth") ) {
+        isValid = getDouble(val, siteWidth);
+      }
+      else if( key.equals("Sitespacing") ) {
+        isValid = getDouble(val, siteSpacing);
+      }
+      else if( key.equals("SubrowOrigin") ) {
+        isValid = getDouble(val, subrowOrigin);
+      }
+      else if( key.equals("NumSites") ) {
+        isValid = getInt(val, numSites);
+      }
+
+      if( !isValid ) {
+        error = "Invalid row: " + line;
+        return false;
+      }
+    }
+
+    if( tokens[0].equals("End") ) {
+      if( data.rows.empty() ) {
+        data.siteSizeX = getScaled(siteWidth, scale);
+        data.siteSizeY = getScaled(height, scale);
+      }
+
+      PlacerBaseData::Box row;
+      row.lx = getScaled(subrowOrigin, scale);
+      row.ly = getScaled(coordinate, scale);
+      row.ux = getScaled(subrowOrigin + numSites * siteSpacing, scale);
+      row.uy = getScaled(coordinate + height, scale);
+      data.rows.push_back(row);
+    }
+  }
+
+  if( data.rows.empty() ) {
+    error = "No rows in .scl file: " + sclFileName;
+    return false;
+  }
+  return true;
+}
+
+static bool
+readNodes(const string& nodesFileName,
+    vector<NodeData>& nodes, NodeMap& nodeMap,
+    string& error) {
+  MappedFile file;
+  if( !file.open(nodesFileName) ) {
+    error = "Cannot open .nodes file: " + nodesFileName;
+    return false;
+  }
+
+  vector<const char*> bounds
+    = getChunkBounds(file.begin(), file.end(), nullptr);
+  const int chunkCnt = bounds.size() - 1;
+  vector<vector<NodeData>> chunkNodes(chunkCnt);
+  vector<string> chunkErrors(chunkCnt);
+
+#pragma omp parallel for schedule(dynamic, 1)
+  for(int i=0; i<chunkCnt; i++) {
+    parseNodesChunk(bounds[i], bounds[i+1],
+        chunkNodes[i], chunkErrors[i]);
+  }
+
+  size_t nodeCnt = 0;
+  for(int i=0; i<chunkCnt; i++) {
+    if( !chunkErrors[i].empty() ) {
+      error = chunkErrors[i];
+      return false;
+    }
+    nodeCnt += chunkNodes[i].size();
+  }
+
+  nodes.reserve(nodeCnt);
+  nodeMap.reserve(nodeCnt);
+  for(auto& chunk : chunkNodes) {
+    for(auto& node : chunk) {
+      if( !nodeMap.emplace(node.name, nodes.size()).second ) {
+        error = "Duplicated node: " + node.name;
+        return false;
+      }
+      nodes.push_back(std::move(node));
+    }
+    vector<NodeData>().swap(chunk);
+  }
+  return true;
+}
+
+static bool
+readPl(const string& plFileName,
+    const NodeMap& nodeMap,
+    vector<NodeLoc>& locs,
+    string& error) {
+  MappedFile file;
+  if( !file.open(plFileName) ) {
+    error = "Cannot open .pl file: " + plFileName;
+    return false;
+  }
+
+  vector<const char*> bounds
+    = getChunkBounds(file.begin(), file.end(), nullptr);
+  const int chunkCnt = bounds.size() - 1;
+  vector<vector<PlData>> chunkPls(chunkCnt);
+  vector<string> chunkErrors(chunkCnt);
+
+#pragma omp parallel for schedule(dynamic, 1)
+  for(int i=0; i<chunkCnt; i++) {
+    parsePlChunk(bounds[i], bounds[i+1], nodeMap,
+        chunkPls[i], chunkErrors[i]);
+  }
+
+  // in file order, so that the last line wins on duplicates
+  for(int i=0; i<chunkCnt; i++) {
+    if( !chunkErrors[i].empty() ) {
+      error = chunkErrors[i];
+      return false;
+    }
+    for(auto& pl : chunkPls[i]) {
+      NodeLoc& loc = locs[pl.node];
+      loc.x = pl.x;
+      loc.y = pl.y;
+      loc.orient = pl.orient;
+      loc.isFixed = pl.isFixed;
+      loc.isNonImage = pl.isNonImage;
+    }
+  }
+  return true;
+}
+
+static bool
+readNets(const string& netsFileName,
+    const NodeIndex& index,
+    PlacerBaseData& data,
+    string& error) {
+  MappedFile file;
+  if( !file.open(netsFileName) ) {
+    error = "Cannot open .nets file: " + netsFileName;
+    return false;
+  }
+
+  vector<const char*> bounds
+    = getChunkBounds(file.begin(), file.end(), isNetDegreeLine);
+  const int chunkCnt = bounds.size() - 1;
+  vector<NetsChunk> chunks(chunkCnt);
+
+#pragma omp parallel for schedule(dynamic, 1)
+  for(int i=0; i<chunkCnt; i++) {
+    parseNetsChunk(bounds[i], bounds[i+1], index, chunks[i]);
+  }
+
+  size_t pinCnt = 0;
+  for(auto& chunk : chunks) {
+    if( !chunk.error.empty() ) {
+      error = chunk.error;
+      return false;
+    }
+    pinCnt += chunk.pins.size();
+  }
+
+  // chunk-local net index -> global net index
+  data.pins.reserve(pinCnt);
+  data.netCnt = 0;
+  for(auto& chunk : chunks) {
+    for(auto& pin : chunk.pins) {
+      pin.net += data.netCnt;
+      data.pins.push_back(pin);
+    }
+    data.netCnt += chunk.netCnt;
+    vector<PlacerBaseData::PinData>().swap(chunk.pins);
+  }
+  return true;
+}
+
+////////////////////////////////////////////////////////
+// BookshelfDesign
+
+BookshelfDesign::BookshelfDesign()
+  : scale(1) {}
+
+static void
+extendBox(PlacerBaseData::Box& box, int lx, int ly, int ux, int uy) {
+  box.lx = min(box.lx, lx);
+  box.ly = min(box.ly, ly);
+  box.ux = max(box.ux, ux);
+  box.uy = max(box.uy, uy);
+}
+
+bool
+readBookshelf(const string& auxFileName,
+    int scale,
+    BookshelfDesign& design,
+    std::shared_ptr<Logger> log) {
+  string nodesFileName, netsFileName, plFileName, sclFileName;
+  string error;
+
+  design = BookshelfDesign();
+  design.scale = scale;
+  PlacerBaseData& data = design.data;
+
+  if( !readAux(auxFileName, nodesFileName, netsFileName,
+        plFileName, sclFileName, error)
+      || !readScl(sclFileName, scale, data, error) ) {
+    log->warn(error, 7);
+    return false;
+  }
+
+  // core : bounding box of rows
+  data.core.lx = data.core.ly = INT_MAX;
+  data.core.ux = data.core.uy = INT_MIN;
+  for(auto& row : data.rows) {
+    extendBox(data.core, row.lx, row.ly, row.ux, row.uy);
+  }
+  data.die = data.core;
+
+  vector<NodeData> nodes;
+  NodeMap nodeMap;
+  if( !readNodes(nodesFileName, nodes, nodeMap, error) ) {
+    log->warn(error, 7);
+    return false;
+  }
+
+  vector<NodeLoc> locs(nodes.size());
+  if( !readPl(plFileName, nodeMap, locs, error) ) {
+    log->warn(error, 7);
+    return false;
+  }
+
+  // nodes to insts/ioNodes
+  vector<int> nodeToInst(nodes.size(), -1);
+  data.insts.reserve(nodes.size());
+  design.instNames.reserve(nodes.size());
+  design.instOrients.reserve(nodes.size());
+  for(size_t i=0; i<nodes.size(); i++) {
+    const NodeData& node = nodes[i];
+    const NodeLoc& loc = locs[i];
+
+    if( node.isNonImage || loc.isNonImage ) {
+      BookshelfDesign::IoNode ioNode;
+      ioNode.name = node.name;
+      ioNode.orient = orientNames[static_cast<int>(loc.orient)];
+      ioNode.x = loc.x;
+      ioNode.y = loc.y;
+      design.ioNodes.push_back(ioNode);
+      continue;
+    }
+
+    const bool isRotatedNode = isRotated(loc.orient);
+    const double width = (isRotatedNode)? node.height : node.width;
+    const double height = (isRotatedNode)? node.width : node.height;
+
+    PlacerBaseData::InstData inst;
+    inst.box.lx = getScaled(loc.x, scale);
+    inst.box.ly = getScaled(loc.y, scale);
+    inst.box.ux = inst.box.lx + getScaled(width, scale);
+    inst.box.uy = inst.box.ly + getScaled(height, scale);
+    inst.isFixed = node.isTerminal || loc.isFixed;
+
+    // die covers fixed objects (e.g. IO pads) outside of rows
+    if( inst.isFixed ) {
+      extendBox(data.die, inst.box.lx, inst.box.ly,
+          inst.box.ux, inst.box.uy);
+    }
+
+    nodeToInst[i] = data.insts.size();
+    data.insts.push_back(inst);
+    design.instNames.push_back(node.name);
+    design.instOrients.push_back(
+        orientNames[static_cast<int>(loc.orient)]);
+  }
+
+  NodeIndex index;
+  index.nodeMap = &nodeMap;
+  index.nodes = &nodes;
+  index.locs = &locs;
+  index.nodeToInst = &nodeToInst;
+  index.scale = scale;
+  if( !readNets(netsFileName, index, data, error) ) {
+    log->warn(error, 7);
+    return false;
+  }
+
+  for(auto& pin : data.pins) {
+    if( pin.inst < 0 ) {
+      extendBox(data.die, pin.x, pin.y, pin.x, pin.y);
+    }
+  }
+
+  log->infoString("BookshelfRead", auxFileName);
+  return true;
+}
+
+////////////////////////////////////////////////////////
+// Writers
+
+static string
+getCoordiString(double val) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.15g", val);
+  return buf;
+}
+
+bool
+writeBookshelfPl(const string& plFileName,
+    const BookshelfDesign& design,
+    const PlacerBaseData& data,
+    std::shared_ptr<Logger> log) {
+  if( data.insts.size() != design.instNames.size() ) {
+    log->warn("Instance count mismatch with the Bookshelf design", 7);
+    return false;
+  }
+
+  ofstream out(plFileName);
+  if( !out.good() ) {
+    log->warn("Cannot open .pl file: " + plFileName, 7);
+    return false;
+  }
+
+  out << "UCLA pl 1.0\n";
+  out << "# Created by RePlAce\n\n";
+
+  const double scale = design.scale;
+  for(size_t i=0; i<data.insts.size(); i++) {
+    const PlacerBaseData::InstData& inst = data.insts[i];
+    out << design.instNames[i] << " "
+      << getCoordiString(inst.box.lx / scale) << " "
+      << getCoordiString(inst.box.ly / scale) << " : "
+      << design.instOrients[i];
+    if( inst.isFixed ) {
+      out << " /FIXED";
+    }
+    out << "\n";
+  }
+
+  for(auto& ioNode : design.ioNodes) {
+    out << ioNode.name << " "
+      << getCoordiString(ioNode.x) << " "
+      << getCoordiString(ioNode.y) << " : "
+      << ioNode.orient << " /FIXED_NI\n";
+  }
+
+  if( !out.good() ) {
+    log->warn("Failed to write .pl file: " + plFileName, 7);
+    return false;
+  }
+
+  log->infoString("BookshelfPlWritten", plFileName);
+  return true;
+}
+
+bool
+writeBookshelf(const string& auxFileName,
+    const PlacerBaseData& data,
+    std::shared_ptr<Logger> log) {
+  string baseName = auxFileName;
+  const string ext = ".aux";
+  if( baseName.size() > ext.size()
+      && baseName.compare(baseName.size() - ext.size(),
+        ext.size(), ext) == 0 ) {
+    baseName.erase(baseName.size() - ext.size());
+  }
+
+  // file names in .aux are relative to .aux
+  string fileName = baseName;
+  const size_t slashPos = baseName.find_last_of('/');
+  if( slashPos != string::npos ) {
+    fileName = baseName.substr(slashPos + 1);
+  }
+
+  int ioCnt = 0, fixedCnt = 0;
+  for(auto& pin : data.pins) {
+    if( pin.inst < 0 ) {
+      ioCnt++;
+    }
+  }
+  for(auto& inst : data.insts) {
+    if( inst.isFixed ) {
+      fixedCnt++;
+    }
+  }
+
+  ofstream aux(baseName + ".aux");
+  ofstream nodes(baseName + ".nodes");
+  ofstream nets(baseName + ".nets");
+  ofstream wts(baseName + ".wts");
+  ofstream pl(baseName + ".pl");
+  ofstream scl(baseName + ".scl");
+  if( !aux.good() || !nodes.good() || !nets.good()
+      || !wts.good() || !pl.good() || !scl.good() ) {
+    log->warn("Cannot open Bookshelf files: " + baseName + ".*", 7);
+    return false;
+  }
+
+  aux << "RowBasedPlacement : "
+    << fileName << ".nodes " << fileName << ".nets "
+    << fileName << ".wts " << fileName << ".pl "
+    << fileName << ".scl\n";
+
+  nodes << "UCLA nodes 1.0\n# Created by RePlAce\n\n";
+  nodes << "NumNodes : " << data.insts.size() + ioCnt << "\n";
+  nodes << "NumTerminals : " << fixedCnt + ioCnt << "\n";
+  pl << "UCLA pl 1.0\n# Created by RePlAce\n\n";
+  for(size_t i=0; i<data.insts.size(); i++) {
+    const PlacerBaseData::InstData& inst = data.insts[i];
+    nodes << "o" << i << " " << inst.box.ux - inst.box.lx
+      << " " << inst.box.uy - inst.box.ly
+      << ((inst.isFixed)? " terminal\n" : "\n");
+    pl << "o" << i << " " << inst.box.lx << " " << inst.box.ly
+      << " : N" << ((inst.isFixed)? " /FIXED\n" : "\n");
+  }
+
+  // IO pins in data.pins order
+  int ioIdx = 0;
+  for(auto& pin : data.pins) {
+    if( pin.inst < 0 ) {
+      nodes << "p" << ioIdx << " 0 0 terminal_NI\n";
+      pl << "p" << ioIdx << " " << pin.x << " " << pin.y
+        << " : N /FIXED_NI\n";
+      ioIdx++;
+    }
+  }
+
+  // group pins by net (counting sort)
+  vector<int> netPinBegins(data.netCnt + 1, 0);
+  for(auto& pin : data.pins) {
+    netPinBegins[pin.net + 1]++;
+  }
+  for(int i=0; i<data.netCnt; i++) {
+    netPinBegins[i+1] += netPinBegins[i];
+  }
+  vector<int> netPins(data.pins.size());
+  vector<int> ioIdxs(data.pins.size(), -1);
+  {
+    vector<int> netPinEnds(netPinBegins.begin(), netPinBegins.end() - 1);
+    ioIdx = 0;
+    for(size_t i=0; i<data.pins.size(); i++) {
+      netPins[netPinEnds[data.pins[i].net]++] = i;
+      if( data.pins[i].inst < 0 ) {
+        ioIdxs[i] = ioIdx++;
+      }
+    }
+  }
+
+  nets << "UCLA nets 1.0\n# Created by RePlAce\n\n";
+  nets << "NumNets : " << data.netCnt << "\n";
+  nets << "NumPins : " << data.pins.size() << "\n\n";
+  for(int i=0; i<data.netCnt; i++) {
+    nets << "NetDegree : " << netPinBegins[i+1] - netPinBegins[i]
+      << " n" << i << "\n";
+    for(int j=netPinBegins[i]; j<netPinBegins[i+1]; j++) {
+      const PlacerBaseData::PinData& pin = data.pins[netPins[j]];
+      if( pin.inst >= 0 ) {
+        nets << "  o" << pin.inst << " B : "
+          << pin.x << " " << pin.y << "\n";
+      }
+      else {
+        nets << "  p" << ioIdxs[netPins[j]] << " B : 0 0\n";
+      }
+    }
+  }
+
+  wts << "UCLA wts 1.0\n# Created by RePlAce\n";
+
+  scl << "UCLA scl 1.0\n# Created by RePlAce\n\n";
+  scl << "NumRows : " << data.rows.size() << "\n\n";
+  const int siteSizeX = max(1, data.siteSizeX);
+  for(auto& row : data.rows) {
+    scl << "CoreRow Horizontal\n"
+      << "  Coordinate    : " << row.ly << "\n"
+      << "  Height        : " << row.uy - row.ly << "\n"
+      << "  Sitewidth     : " << siteSizeX << "\n"
+      << "  Sitespacing   : " << siteSizeX << "\n"
+      << "  Siteorient    : 1\n"
+      << "  Sitesymmetry  : 1\n"
+      << "  SubrowOrigin  : " << row.lx
+      << "  NumSites : " << (row.ux - row.lx) / siteSizeX << "\n"
+      << "End\n";
+  }
+
+  if( !aux.good() || !nodes.good() || !nets.good()
+      || !wts.good() || !pl.good() || !scl.good() ) {
+    log->warn("Failed to write Bookshelf files: " + baseName + ".*", 7);
+    return false;
+  }
+
+  log->infoString("BookshelfWritten", baseName + ".aux");
+  return true;
+}
+
+}
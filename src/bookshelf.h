@@ -0,0 +1,71 @@
+#ifndef __REPLACE_BOOKSHELF__
+#define __REPLACE_BOOKSHELF__
+
+#include "placerBase.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace replace {
+
+class Logger;
+
+//
+// Bookshelf (.aux/.nodes/.nets/.pl/.scl) front end
+// to build PlacerBase without OpenDB.
+//
+// Bookshelf coordinates are multiplied by scale
+// and rounded to integers (e.g. scale 1000 for
+// ISPD 2005/2006 suites, whose row height is 12).
+//
+// terminal     : fixed instance
+// terminal_NI  : IO pin (PlacerBaseData::PinData::inst == -1)
+//
+class BookshelfDesign {
+public:
+  class IoNode {
+  public:
+    std::string name;
+    std::string orient;
+    double x, y;
+  };
+
+  PlacerBaseData data;
+
+  // aligned with data.insts
+  std::vector<std::string> instNames;
+  std::vector<std::string> instOrients;
+
+  // terminal_NI nodes; written back as they are.
+  std::vector<IoNode> ioNodes;
+
+  int scale;
+
+  BookshelfDesign();
+};
+
+// Both return false on I/O or format errors.
+bool readBookshelf(const std::string& auxFileName,
+    int scale,
+    BookshelfDesign& design,
+    std::shared_ptr<Logger> log);
+
+// write data as a Bookshelf design (e.g. snapshots and
+// synthetic designs for other placers).
+// insts/nets are named o<index>/n<index>, and
+// IO pins become terminal_NI nodes p<index>.
+bool writeBookshelf(const std::string& auxFileName,
+    const PlacerBaseData& data,
+    std::shared_ptr<Logger> log);
+
+// write the current instance locations.
+// data must be PlacerBase::toData() of the design read above.
+bool writeBookshelfPl(const std::string& plFileName,
+    const BookshelfDesign& design,
+    const PlacerBaseData& data,
+    std::shared_ptr<Logger> log);
+
+}
+
+#endif
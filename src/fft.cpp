@@ -14,7 +14,9 @@ namespace replace {
 
 
 FFT::FFT()
-  : binCntX_(0), binCntY_(0), binSizeX_(0), binSizeY_(0) {}
+  : binDensity_(nullptr), electroPhi_(nullptr),
+  electroForceX_(nullptr), electroForceY_(nullptr),
+  binCntX_(0), binCntY_(0), binSizeX_(0), binSizeY_(0) {}
 
 FFT::FFT(int binCntX, int binCntY, int binSizeX, int binSizeY)
   : binCntX_(binCntX), binCntY_(binCntY), 
@@ -24,16 +26,10 @@ FFT::FFT(int binCntX, int binCntY, int binSizeX, int binSizeY)
 
 FFT::~FFT() {
   using std::vector;
-  for(int i=0; i<binCntX_; i++) {
-    delete(binDensity_[i]);
-    delete(electroPhi_[i]);
-    delete(electroForceX_[i]);
-    delete(electroForceY_[i]);
-  }
-  delete(binDensity_);
-  delete(electroPhi_);
-  delete(electroForceX_);
-  delete(electroForceY_);
+  delete[] binDensity_;
+  delete[] electroPhi_;
+  delete[] electroForceX_;
+  delete[] electroForceY_;
 
 
   csTable_.clear();
@@ -53,19 +49,15 @@ FFT::init() {
   electroForceX_ = new float*[binCntX_];
   electroForceY_ = new float*[binCntX_];
 
+  // zero filled
+  const size_t arraySize = static_cast<size_t>(binCntX_) * binCntY_;
+  arrayStor_.resize(4 * arraySize, 0.0f);
+  float* stor = arrayStor_.data();
   for(int i=0; i<binCntX_; i++) {
-    binDensity_[i] = new float[binCntY_];
-    electroPhi_[i] = new float[binCntY_];
-    electroForceX_[i] = new float[binCntY_];
-    electroForceY_[i] = new float[binCntY_];
-
-    for(int j=0; j<binCntY_; j++) {
-      binDensity_[i][j] 
-        = electroPhi_[i][j] 
-        = electroForceX_[i][j] 
-        = electroForceY_[i][j] 
-        = 0.0f;  
-    }
+    binDensity_[i] = stor + i * binCntY_;
+    electroPhi_[i] = stor + arraySize + i * binCntY_;
+    electroForceX_[i] = stor + 2 * arraySize + i * binCntY_;
+    electroForceY_[i] = stor + 3 * arraySize + i * binCntY_;
   }
 
   csTable_.resize( std::max(binCntX_, binCntY_) * 3 / 2, 0 );
@@ -109,6 +101,19 @@ FFT::getElectroPhi(int x, int y) {
   return electroPhi_[x][y]; 
 }
 
+int64_t
+FFT::memoryBytes() const {
+  // 4 arrays of binCntX_ rows
+  const int64_t arrayBytes = 4 * static_cast<int64_t>(binCntX_)
+    * sizeof(float*) 
+    + static_cast<int64_t>(arrayStor_.capacity()) * sizeof(float);
+  return arrayBytes
+    + static_cast<int64_t>(csTable_.capacity()) * sizeof(float)
+    + static_cast<int64_t>(wx_.capacity() + wxSquare_.capacity()
+        + wy_.capacity() + wySquare_.capacity()) * sizeof(float)
+    + static_cast<int64_t>(workArea_.capacity()) * sizeof(int);
+}
+
 using namespace std;
 
 void
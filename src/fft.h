@@ -2,6 +2,9 @@
 #define __REPLACE_FFT__
 
 #include <vector>
+#include <cstdint>
+
+#include "largeArray.h"
 
 namespace replace {
 
@@ -21,14 +24,21 @@ class FFT {
     std::pair<float, float> getElectroForce(int x, int y);
     float getElectroPhi(int x, int y);
 
+    // heap bytes of the 2D arrays and tables
+    int64_t memoryBytes() const;
+
   private:
     // 2D array; width: binCntX_, height: binCntY_;
     // No hope to use Vector at this moment...
+    // Rows point into arrayStor_.
     float** binDensity_;
     float** electroPhi_;
     float** electroForceX_;
     float** electroForceY_;
 
+    // the four 2D arrays in one block
+    std::vector<float, LargeArrayAllocator<float>> arrayStor_;
+
     // cos/sin table (prev: w_2d)
     // length:  max(binCntX, binCntY) * 3 / 2
     std::vector<float> csTable_;
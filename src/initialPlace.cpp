@@ -1,7 +1,14 @@
 #include "initialPlace.h"
 #include "placerBase.h"
 #include "logger.h" 
+#include "parallel.h"
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include <Eigen/IterativeLinearSolvers>
 
@@ -11,17 +18,27 @@ namespace replace {
 using namespace std;
 
 using Eigen::BiCGSTAB;
+using Eigen::ConjugateGradient;
 using Eigen::IdentityPreconditioner;
+using Eigen::DiagonalPreconditioner;
+using Eigen::IncompleteCholesky;
 
 typedef Eigen::Triplet< float > T;
 
+static float
+solveSparseMatrix(const InitialPlaceVars& ipVars, const SMatrix& mat,
+    const Eigen::VectorXf& rhs, Eigen::VectorXf& sol, 
+    int& iterCnt, double& runtime);
+
 InitialPlaceVars::InitialPlaceVars() 
   : maxIter(20), 
   minDiffLength(1500), 
   maxSolverIter(100),
   maxFanout(200),
   netWeightScale(800.0),
-  incrementalPlaceMode(false) {}
+  incrementalPlaceMode(false),
+  solver(InitialPlaceSolver::BiCGSTAB),
+  precond(InitialPlacePrecond::None) {}
 
 void InitialPlaceVars::reset() {
   maxIter = 20;
@@ -30,15 +47,21 @@ void InitialPlaceVars::reset() {
   maxFanout = 200;
   netWeightScale = 800.0;
   incrementalPlaceMode = false;
+  solver = InitialPlaceSolver::BiCGSTAB;
+  precond = InitialPlacePrecond::None;
 }
 
 InitialPlace::InitialPlace()
-: ipVars_(), pb_(nullptr), log_(nullptr) {} 
+: ipVars_(), pb_(nullptr), log_(nullptr),
+  isSparsityPatternInit_(false),
+  patternTripletBytes_(0) {} 
 
 InitialPlace::InitialPlace(InitialPlaceVars ipVars, 
     std::shared_ptr<PlacerBase> pb,
     std::shared_ptr<Logger> log)
-: ipVars_(ipVars), pb_(pb), log_(log) {}
+: ipVars_(ipVars), pb_(pb), log_(log),
+  isSparsityPatternInit_(false),
+  patternTripletBytes_(0) {}
 
 InitialPlace::~InitialPlace() {
   reset();
@@ -47,6 +70,51 @@ InitialPlace::~InitialPlace() {
 void InitialPlace::reset() {
   pb_ = nullptr;
   ipVars_.reset();
+
+  b2bNets_.clear();
+  b2bPairBegins_.clear();
+  b2bPairs_.clear();
+  b2bWeightsX_.clear();
+  b2bWeightsY_.clear();
+  diagSlots_.clear();
+  b2bNetChunkBegins_.clear();
+  isSparsityPatternInit_ = false;
+  patternTripletBytes_ = 0;
+  b2bLargeNets_.clear();
+  largeNetTripletsX_.clear();
+  largeNetTripletsY_.clear();
+}
+
+// values/inner indices + outer (and inner nonzero) indices
+static int64_t
+getMatrixBytes(const SMatrix& mat) {
+  int64_t bytes = static_cast<int64_t>(mat.data().allocatedSize())
+    * (sizeof(SMatrix::Scalar) + sizeof(SMatrix::StorageIndex))
+    + static_cast<int64_t>(mat.outerSize() + 1) 
+    * sizeof(SMatrix::StorageIndex);
+  if( !mat.isCompressed() ) {
+    bytes += mat.outerSize() * sizeof(SMatrix::StorageIndex);
+  }
+  return bytes;
+}
+
+int64_t
+InitialPlace::memoryBytes() const {
+  return static_cast<int64_t>(instLocVecX_.size() + fixedInstForceVecX_.size()
+      + instLocVecY_.size() + fixedInstForceVecY_.size()) * sizeof(float)
+    + getMatrixBytes(placeInstForceMatrixX_)
+    + getMatrixBytes(placeInstForceMatrixY_)
+    + getCapacityBytes(b2bNets_)
+    + getCapacityBytes(b2bPairBegins_)
+    + getCapacityBytes(b2bPairs_)
+    + getCapacityBytes(b2bWeightsX_)
+    + getCapacityBytes(b2bWeightsY_)
+    + getCapacityBytes(diagSlots_)
+    + getCapacityBytes(b2bNetChunkBegins_)
+    + getCapacityBytes(b2bLargeNets_)
+    + getCapacityBytes(largeNetTripletsX_)
+    + getCapacityBytes(largeNetTripletsY_)
+    + patternTripletBytes_;
 }
 
 #ifdef ENABLE_CIMG_LIB
@@ -55,6 +123,7 @@ static PlotEnv pe;
 
 void InitialPlace::doBicgstabPlace() {
   log_->procBegin("InitialPlace", 3);
+  ProfileScope scope(log_, "InitialPlace");
 
   float errorX = 0.0f, errorY = 0.0f;
 
@@ -71,24 +140,52 @@ void InitialPlace::doBicgstabPlace() {
   // set ExtId for idx reference // easy recovery
   setPlaceInstExtId();
   for(int i=1; i<=ipVars_.maxIter; i++) {
-    updatePinInfo();
-    createSparseMatrix();
+    {
+      ProfileScope scope(log_, "B2BAssembly");
+      updatePinInfo();
+      createSparseMatrix();
+    }
 
-    // BiCGSTAB solver for initial place
-    BiCGSTAB< SMatrix, IdentityPreconditioner > solver;
-    solver.setMaxIterations(ipVars_.maxSolverIter);
-    solver.compute(placeInstForceMatrixX_);
-    instLocVecX_ = solver.solveWithGuess(fixedInstForceVecX_, instLocVecX_);
-    errorX = solver.error();
+    // BiCGSTAB or CG solver for initial place.
+    // X and Y are independent, so solve them concurrently.
+    // Each solver's SpMV (Eigen's row-partitioned RowMajor kernel) 
+    // takes half of the threads through nested parallelism.
+    int iterCntX = 0, iterCntY = 0;
+    double timeX = 0, timeY = 0;
+#ifdef _OPENMP
+    const int prevActiveLevels = omp_get_max_active_levels();
+    const int prevEigenThreads = Eigen::nbThreads();
+    omp_set_max_active_levels(2);
+    Eigen::setNbThreads( std::max(1, getMaxThreads() / 2) );
+#endif
 
-    solver.compute(placeInstForceMatrixY_);
-    instLocVecY_ = solver.solveWithGuess(fixedInstForceVecY_, instLocVecY_);
-    errorY = solver.error();
+    {
+      ProfileScope scope(log_, "Solve");
+#pragma omp parallel sections num_threads(2)
+      {
+#pragma omp section
+        errorX = solveSparseMatrix(ipVars_, placeInstForceMatrixX_,
+            fixedInstForceVecX_, instLocVecX_, iterCntX, timeX);
+#pragma omp section
+        errorY = solveSparseMatrix(ipVars_, placeInstForceMatrixY_, 
+            fixedInstForceVecY_, instLocVecY_, iterCntY, timeY);
+      }
+    }
+
+#ifdef _OPENMP
+    omp_set_max_active_levels(prevActiveLevels);
+    Eigen::setNbThreads(prevEigenThreads);
+#endif
 
     cout << "[InitialPlace]  Iter: " << i 
       << " CG Error: " << max(errorX, errorY)
       << " HPWL: " << pb_->hpwl() << endl; 
-    updateCoordi();
+    log_->infoIntPair("  SolverIterations", iterCntX, iterCntY, 1);
+    log_->infoFloatPair("  SolverRuntime", timeX, timeY, 1);
+    {
+      ProfileScope scope(log_, "UpdateCoordi");
+      updateCoordi();
+    }
 
 #ifdef ENABLE_CIMG_LIB
     pe.SaveCellPlotAsJPEG(
@@ -104,6 +201,74 @@ void InitialPlace::doBicgstabPlace() {
   log_->procEnd("InitialPlace", 3);
 }
 
+// Solve mat * sol = rhs with the given Solver type.
+// sol is used as an initial guess.
+template <class Solver>
+static float
+solveSparseMatrix(int maxIter, const SMatrix& mat, 
+    const Eigen::VectorXf& rhs, Eigen::VectorXf& sol, int& iterCnt) {
+  Solver solver;
+  solver.setMaxIterations(maxIter);
+  solver.compute(mat);
+  sol = solver.solveWithGuess(rhs, sol);
+  iterCnt = solver.iterations();
+  return solver.error();
+}
+
+// returns the solver error.
+// iterCnt/runtime are the number of solver iterations and seconds.
+static float
+solveSparseMatrix(const InitialPlaceVars& ipVars, const SMatrix& mat,
+    const Eigen::VectorXf& rhs, Eigen::VectorXf& sol, 
+    int& iterCnt, double& runtime) {
+  auto startTime = std::chrono::steady_clock::now();
+  float error = 0;
+
+  // Lower|Upper uses the full (symmetric) matrix on CG.
+  typedef ConjugateGradient< SMatrix, Eigen::Lower|Eigen::Upper,
+          IdentityPreconditioner > CGNone;
+  typedef ConjugateGradient< SMatrix, Eigen::Lower|Eigen::Upper,
+          DiagonalPreconditioner<float> > CGJacobi;
+  typedef ConjugateGradient< SMatrix, Eigen::Lower|Eigen::Upper,
+          IncompleteCholesky<float> > CGIChol;
+
+  typedef BiCGSTAB< SMatrix, IdentityPreconditioner > BiCGSTABNone;
+  typedef BiCGSTAB< SMatrix, DiagonalPreconditioner<float> > BiCGSTABJacobi;
+  typedef BiCGSTAB< SMatrix, IncompleteCholesky<float> > BiCGSTABIChol;
+
+  const int maxIter = ipVars.maxSolverIter;
+  if( ipVars.solver == InitialPlaceSolver::CG ) {
+    switch( ipVars.precond ) {
+      case InitialPlacePrecond::None:
+        error = solveSparseMatrix<CGNone>(maxIter, mat, rhs, sol, iterCnt);
+        break;
+      case InitialPlacePrecond::Jacobi:
+        error = solveSparseMatrix<CGJacobi>(maxIter, mat, rhs, sol, iterCnt);
+        break;
+      case InitialPlacePrecond::IncompleteCholesky:
+        error = solveSparseMatrix<CGIChol>(maxIter, mat, rhs, sol, iterCnt);
+        break;
+    }
+  }
+  else {
+    switch( ipVars.precond ) {
+      case InitialPlacePrecond::None:
+        error = solveSparseMatrix<BiCGSTABNone>(maxIter, mat, rhs, sol, iterCnt);
+        break;
+      case InitialPlacePrecond::Jacobi:
+        error = solveSparseMatrix<BiCGSTABJacobi>(maxIter, mat, rhs, sol, iterCnt);
+        break;
+      case InitialPlacePrecond::IncompleteCholesky:
+        error = solveSparseMatrix<BiCGSTABIChol>(maxIter, mat, rhs, sol, iterCnt);
+        break;
+    }
+  }
+
+  runtime = std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - startTime).count();
+  return error;
+}
+
 // starting point of initial place is center.
 void InitialPlace::placeInstsCenter() {
   const int centerX = pb_->die().coreCx();
@@ -181,200 +346,518 @@ void InitialPlace::updatePinInfo() {
   } 
 }
 
-// solve placeInstForceMatrixX_ * xcg_x_ = xcg_b_ and placeInstForceMatrixY_ * ycg_x_ = ycg_b_ eq.
-void InitialPlace::createSparseMatrix() {
-  const int placeCnt = pb_->placeInsts().size();
-  instLocVecX_.resize( placeCnt );
-  fixedInstForceVecX_.resize( placeCnt );
-  instLocVecY_.resize( placeCnt );
-  fixedInstForceVecY_.resize( placeCnt );
+B2BPinPair::B2BPinPair() 
+  : inst1(-1), inst2(-1), slot12(-1), slot21(-1) {}
 
-  placeInstForceMatrixX_.resize( placeCnt, placeCnt );
-  placeInstForceMatrixY_.resize( placeCnt, placeCnt );
+// Nets with pins <= this value reuse the union sparsity pattern
+// of all pin pairs. Larger nets are assembled on every iteration,
+// because the union pattern grows in O(p^2).
+static const size_t b2bPatternMaxPinCnt = 16;
 
+static bool
+isB2BTargetNet(const Net* net, const InitialPlaceVars& ipVars) {
+  // skip for small nets.
+  if( net->pins().size() <= 1 ) {
+    return false;
+  }
+  // escape huge fanout.
+  if( net->pins().size() >= ipVars.maxFanout) { 
+    return false;
+  }
+  return true;
+}
 
-  // 
-  // listX and listY is a temporary vector that have tuples, (idx1, idx2, val)
-  //
-  // listX finally becomes placeInstForceMatrixX_
-  // listY finally becomes placeInstForceMatrixY_
-  //
-  // The triplet vector is recommended usages 
-  // to fill in SparseMatrix from Eigen docs.
-  //
+static bool
+isB2BPatternNet(const Net* net) {
+  return net->pins().size() <= b2bPatternMaxPinCnt;
+}
 
-  vector< T > listX, listY;
-  listX.reserve(1000000);
-  listY.reserve(1000000);
+// number of lower-triangle pin pairs (including itself)
+static size_t
+getPinPairCnt(size_t pinCnt) {
+  return pinCnt * (pinCnt + 1) / 2;
+}
 
-  // initialize vector
-  for(auto& inst : pb_->placeInsts()) {
-    int idx = inst->extId(); 
-    
-    instLocVecX_(idx) = inst->cx();
-    instLocVecY_(idx) = inst->cy();
+// index of (pinIdx1, pinIdx2) in a net's lower-triangle pin pairs
+static size_t
+getPinPairIdx(size_t pinIdx1, size_t pinIdx2) {
+  if( pinIdx1 < pinIdx2 ) {
+    std::swap(pinIdx1, pinIdx2);
+  }
+  return getPinPairCnt(pinIdx1) + pinIdx2;
+}
 
-    fixedInstForceVecX_(idx) = fixedInstForceVecY_(idx) = 0;
+static float
+getB2BWeight(int diff, float netWeight, int minDiffLength) {
+  if( diff > minDiffLength ) {
+    return netWeight / diff;
   }
+  else {
+    return netWeight / minDiffLength;
+  }
+}
 
-  // for each net
-  for(auto& net : pb_->nets()) {
+// Call func(pinIdx1, pinIdx2) on B2B pin pairs of one axis in O(p).
+//
+// B2B only connects each pin with min/max pins, so the pairs are
+// (pin, minPin) for all pins except minPin and
+// (pin, maxPin) for all pins except minPin/maxPin.
+// If all pins are on the same coordinate, updatePinInfo marks
+// the same pin as minPin and maxPin, and the pairs are only
+// (pin, minPin).
+//
+// isMinPin/isMaxPin : &Pin::isMinPinX, &Pin::isMaxPinX for X.
+//                     &Pin::isMinPinY, &Pin::isMaxPinY for Y.
+template <class Func>
+static void
+forEachB2BPinPair(PointerRange<Pin> pins,
+    bool (Pin::*isMinPin)() const,
+    bool (Pin::*isMaxPin)() const,
+    Func func) {
+  int minIdx = -1, maxIdx = -1;
+  const int pinCnt = pins.size();
+  for(int i=0; i<pinCnt; i++) {
+    if( (pins[i]->*isMinPin)() ) {
+      minIdx = i;
+    }
+    if( (pins[i]->*isMaxPin)() ) {
+      maxIdx = i;
+    }
+  }
 
-    // skip for small nets.
-    if( net->pins().size() <= 1 ) {
-      continue;
+  if( minIdx < 0 || maxIdx < 0 ) {
+    return;
+  }
+
+  for(int i=0; i<pinCnt; i++) {
+    if( i != minIdx ) {
+      func(i, minIdx);
     }
- 
-    // escape long time cals on huge fanout.
-    //
-    if( net->pins().size() >= ipVars_.maxFanout) { 
-      continue;
+  }
+  if( maxIdx == minIdx ) {
+    return;
+  }
+  for(int i=0; i<pinCnt; i++) {
+    if( i != minIdx && i != maxIdx ) {
+      func(i, maxIdx);
     }
+  }
+}
+
+// index of (row, col) in valuePtr(). -1 if not exist
+static int
+getSlot(const SMatrix& mat, int row, int col) {
+  const int* begin = mat.innerIndexPtr() + mat.outerIndexPtr()[row];
+  const int* end = mat.innerIndexPtr() + mat.outerIndexPtr()[row+1];
+  const int* found = std::lower_bound(begin, end, col);
+  if( found == end || *found != col ) {
+    return -1;
+  }
+  return found - mat.innerIndexPtr();
+}
 
-    float netWeight = ipVars_.netWeightScale 
-      / (net->pins().size() - 1);
-    //cout << "net: " << net.net()->getConstName() << endl;
-
-    // foreach two pins in single nets.
-    for(auto& pin1 : net->pins()) {
-      int pinIdx1 = &pin1 - &(net->pins()[0]);
-      for(auto& pin2 : net->pins()) {
-        int pinIdx2 = &pin2 - &(net->pins()[0]);
-
-        // 
-        // will compare two pins "only once."
-        //
-        if( pinIdx1 < pinIdx2 ) {
-          break;
+// Add fixed forces of a B2B pin pair.
+// inst1/inst2 : extId of pin1/pin2's place instances. -1 if not placeable.
+static void
+addB2BFixedForce(const Pin* pin1, const Pin* pin2,
+    int inst1, int inst2, float weight,
+    int (Pin::*pinCoordi)() const,
+    int (Instance::*instCoordi)() const,
+    Eigen::VectorXf& fixedInstForceVec) {
+
+  // both pin cames from instance
+  if( inst1 >= 0 && inst2 >= 0 ) {
+    fixedInstForceVec(inst1) += 
+      -weight * (
+      ((pin1->*pinCoordi)() - (pin1->instance()->*instCoordi)()) - 
+      ((pin2->*pinCoordi)() - (pin2->instance()->*instCoordi)()));
+
+    fixedInstForceVec(inst2) += 
+      -weight * (
+      ((pin2->*pinCoordi)() - (pin2->instance()->*instCoordi)()) - 
+      ((pin1->*pinCoordi)() - (pin1->instance()->*instCoordi)()));
+  }
+  // pin1 from IO port / pin2 from Instance
+  else if( inst2 >= 0 ) {
+    fixedInstForceVec(inst2) += weight * 
+      ( (pin1->*pinCoordi)() - 
+        ( (pin2->*pinCoordi)() - (pin2->instance()->*instCoordi)()) );
+  }
+  // pin1 from Instance / pin2 from IO port
+  else if( inst1 >= 0 ) {
+    fixedInstForceVec(inst1) += weight * 
+      ( (pin2->*pinCoordi)() - 
+        ( (pin1->*pinCoordi)() - (pin1->instance()->*instCoordi)()) );
+  }
+}
+
+// Fill in the values and fixed forces of one axis 
+// with the given B2B weights.
+//
+// pinCoordi/instCoordi : &Pin::cx, &Instance::cx for X.
+//                        &Pin::cy, &Instance::cy for Y.
+static void
+updateSparseMatrixValues(
+    const std::vector<const Net*>& nets,
+    const std::vector<size_t>& pairBegins,
+    const std::vector<B2BPinPair>& pairs,
+    const std::vector<float>& weights,
+    const std::vector<int>& diagSlots,
+    int (Pin::*pinCoordi)() const,
+    int (Instance::*instCoordi)() const,
+    SMatrix& mat, 
+    Eigen::VectorXf& fixedInstForceVec) {
+
+  float* values = mat.valuePtr();
+  std::fill(values, values + mat.nonZeros(), 0.0f);
+  fixedInstForceVec.setZero();
+
+  for(size_t i=0; i<nets.size(); i++) {
+    PointerRange<Pin> pins = nets[i]->pins();
+    size_t k = pairBegins[i];
+    for(size_t pinIdx1 = 0; pinIdx1 < pins.size(); pinIdx1++) {
+      for(size_t pinIdx2 = 0; pinIdx2 <= pinIdx1; pinIdx2++, k++) {
+        const float weight = weights[k];
+        if( weight == 0 ) {
+          continue;
+        }
+
+        const B2BPinPair& pair = pairs[k];
+        if( pair.inst1 >= 0 && pair.inst2 >= 0 ) {
+          values[ diagSlots[pair.inst1] ] += weight;
+          values[ diagSlots[pair.inst2] ] += weight;
+          values[ pair.slot12 ] -= weight;
+          values[ pair.slot21 ] -= weight;
+        }
+        else if( pair.inst2 >= 0 ) {
+          values[ diagSlots[pair.inst2] ] += weight;
+        }
+        else {
+          values[ diagSlots[pair.inst1] ] += weight;
         }
 
+        addB2BFixedForce(pins[pinIdx1], pins[pinIdx2], 
+            pair.inst1, pair.inst2, weight,
+            pinCoordi, instCoordi, fixedInstForceVec);
+      }
+    }
+  }
+}
+
+// B2B triplets of large nets on one axis, in O(p) per net.
+// Fixed forces are accumulated on fixedInstForceVec.
+static void
+createLargeNetTriplets(
+    const std::vector<const Net*>& nets,
+    const InitialPlaceVars& ipVars,
+    bool (Pin::*isMinPin)() const,
+    bool (Pin::*isMaxPin)() const,
+    int (Pin::*pinCoordi)() const,
+    int (Instance::*instCoordi)() const,
+    vector< T >& list, 
+    Eigen::VectorXf& fixedInstForceVec) {
+
+  list.clear();
+  for(auto& net : nets) {
+    PointerRange<Pin> pins = net->pins();
+    const float netWeight = ipVars.netWeightScale 
+      / (pins.size() - 1);
+
+    forEachB2BPinPair(pins, isMinPin, isMaxPin, 
+        [&](int pinIdx1, int pinIdx2) {
+      const Pin* pin1 = pins[pinIdx1];
+      const Pin* pin2 = pins[pinIdx2];
+
+      // no need to fill in when instance is same
+      if( pin1->instance() == pin2->instance() ) {
+        return;
+      }
+
+      const int inst1 = (pin1->isPlaceInstConnected())? 
+        pin1->instance()->extId() : -1;
+      const int inst2 = (pin2->isPlaceInstConnected())? 
+        pin2->instance()->extId() : -1;
+      if( inst1 < 0 && inst2 < 0 ) {
+        return;
+      }
+
+      const float weight = getB2BWeight(
+          abs((pin1->*pinCoordi)() - (pin2->*pinCoordi)()),
+          netWeight, ipVars.minDiffLength);
+
+      if( inst1 >= 0 ) {
+        list.push_back( T(inst1, inst1, weight) );
+      }
+      if( inst2 >= 0 ) {
+        list.push_back( T(inst2, inst2, weight) );
+      }
+      if( inst1 >= 0 && inst2 >= 0 ) {
+        list.push_back( T(inst1, inst2, -weight) );
+        list.push_back( T(inst2, inst1, -weight) );
+      }
+
+      addB2BFixedForce(pin1, pin2, inst1, inst2, weight,
+          pinCoordi, instCoordi, fixedInstForceVec);
+    });
+  }
+}
+
+// Add triplets' values on mat in place.
+// Every triplet must be in mat's sparsity pattern.
+static void
+addTripletValues(const vector< T >& list, SMatrix& mat) {
+  float* values = mat.valuePtr();
+  for(auto& triplet : list) {
+    values[ getSlot(mat, triplet.row(), triplet.col()) ] 
+      += triplet.value();
+  }
+}
+
+// Build the union sparsity pattern of all pin pairs in B2B pattern nets 
+// and the index map from pin pairs to nonzero slots.
+// Called only once, because nets and extIds never change in initial place.
+void InitialPlace::initSparsityPattern() {
+  const int placeCnt = pb_->placeInsts().size();
+
+  b2bNets_.clear();
+  b2bPairBegins_.clear();
+  b2bLargeNets_.clear();
+
+  size_t pairCnt = 0;
+  for(auto& net : pb_->nets()) {
+    if( !isB2BTargetNet(net, ipVars_) ) {
+      continue;
+    }
+    if( isB2BPatternNet(net) ) {
+      b2bNets_.push_back(net);
+      b2bPairBegins_.push_back(pairCnt);
+      pairCnt += getPinPairCnt(net->pins().size());
+    }
+    else {
+      b2bLargeNets_.push_back(net);
+    }
+  }
+  b2bPairBegins_.push_back(pairCnt);
+
+  b2bPairs_.assign(pairCnt, B2BPinPair());
+  b2bWeightsX_.assign(pairCnt, 0.0f);
+  b2bWeightsY_.assign(pairCnt, 0.0f);
+
+  vector< T > list;
+  list.reserve(placeCnt);
+
+  for(size_t i=0; i<b2bNets_.size(); i++) {
+    PointerRange<Pin> pins = b2bNets_[i]->pins();
+    size_t k = b2bPairBegins_[i];
+    for(size_t pinIdx1 = 0; pinIdx1 < pins.size(); pinIdx1++) {
+      for(size_t pinIdx2 = 0; pinIdx2 <= pinIdx1; pinIdx2++, k++) {
+        const Pin* pin1 = pins[pinIdx1];
+        const Pin* pin2 = pins[pinIdx2];
+
         // no need to fill in when instance is same
         if( pin1->instance() == pin2->instance() ) {
           continue;
         }
 
-        // B2B modeling on min/maxX pins.
-        if( pin1->isMinPinX() || pin1->isMaxPinX() ||
-            pin2->isMinPinX() || pin2->isMaxPinX() ) {
-          int diffX = abs(pin1->cx() - pin2->cx());
-          float weightX = 0;
-          if( diffX > ipVars_.minDiffLength ) {
-            weightX = netWeight / diffX;
-          }
-          else {
-            weightX = netWeight 
-              / ipVars_.minDiffLength;
-          }
-          //cout << weightX << endl;
-
-          // both pin cames from instance
-          if( pin1->isPlaceInstConnected() 
-              && pin2->isPlaceInstConnected() ) {
-            const int inst1 = pin1->instance()->extId();
-            const int inst2 = pin2->instance()->extId();
-            //cout << "inst: " << inst1 << " " << inst2 << endl;
-
-            listX.push_back( T(inst1, inst1, weightX) );
-            listX.push_back( T(inst2, inst2, weightX) );
-
-            listX.push_back( T(inst1, inst2, -weightX) );
-            listX.push_back( T(inst2, inst1, -weightX) );
-
-            //cout << pin1->cx() << " " 
-            //  << pin1->instance()->cx() << endl;
-            fixedInstForceVecX_(inst1) += 
-              -weightX * (
-              (pin1->cx() - pin1->instance()->cx()) - 
-              (pin2->cx() - pin2->instance()->cx()));
-
-            fixedInstForceVecX_(inst2) +=
-              -weightX * (
-              (pin2->cx() - pin2->instance()->cx()) -
-              (pin1->cx() - pin1->instance()->cx())); 
-          }
-          // pin1 from IO port / pin2 from Instance
-          else if( !pin1->isPlaceInstConnected() 
-              && pin2->isPlaceInstConnected() ) {
-            const int inst2 = pin2->instance()->extId();
-            //cout << "inst2: " << inst2 << endl;
-            listX.push_back( T(inst2, inst2, weightX) );
-            fixedInstForceVecX_(inst2) += weightX * 
-              ( pin1->cx() - 
-                ( pin2->cx() - pin2->instance()->cx()) );
-          }
-          // pin1 from Instance / pin2 from IO port
-          else if( pin1->isPlaceInstConnected() 
-              && !pin2->isPlaceInstConnected() ) {
-            const int inst1 = pin1->instance()->extId();
-            //cout << "inst1: " << inst1 << endl;
-            listX.push_back( T(inst1, inst1, weightX) );
-            fixedInstForceVecX_(inst1) += weightX *
-              ( pin2->cx() -
-                ( pin1->cx() - pin1->instance()->cx()) );
-          }
+        B2BPinPair& pair = b2bPairs_[k];
+        if( pin1->isPlaceInstConnected() ) {
+          pair.inst1 = pin1->instance()->extId();
+          list.push_back( T(pair.inst1, pair.inst1, 1) );
+        }
+        if( pin2->isPlaceInstConnected() ) {
+          pair.inst2 = pin2->instance()->extId();
+          list.push_back( T(pair.inst2, pair.inst2, 1) );
         }
-        
-        // B2B modeling on min/maxY pins.
-        if( pin1->isMinPinY() || pin1->isMaxPinY() ||
-            pin2->isMinPinY() || pin2->isMaxPinY() ) {
-          
-          int diffY = abs(pin1->cy() - pin2->cy());
-          float weightY = 0;
-          if( diffY > ipVars_.minDiffLength ) {
-            weightY = netWeight / diffY;
-          }
-          else {
-            weightY = netWeight 
-              / ipVars_.minDiffLength;
-          }
-
-          // both pin cames from instance
-          if( pin1->isPlaceInstConnected() 
-              && pin2->isPlaceInstConnected() ) {
-            const int inst1 = pin1->instance()->extId();
-            const int inst2 = pin2->instance()->extId();
-
-            listY.push_back( T(inst1, inst1, weightY) );
-            listY.push_back( T(inst2, inst2, weightY) );
-
-            listY.push_back( T(inst1, inst2, -weightY) );
-            listY.push_back( T(inst2, inst1, -weightY) );
-
-            fixedInstForceVecY_(inst1) += 
-              -weightY * (
-              (pin1->cy() - pin1->instance()->cy()) - 
-              (pin2->cy() - pin2->instance()->cy()));
-
-            fixedInstForceVecY_(inst2) +=
-              -weightY * (
-              (pin2->cy() - pin2->instance()->cy()) -
-              (pin1->cy() - pin1->instance()->cy())); 
-          }
-          // pin1 from IO port / pin2 from Instance
-          else if( !pin1->isPlaceInstConnected() 
-              && pin2->isPlaceInstConnected() ) {
-            const int inst2 = pin2->instance()->extId();
-            listY.push_back( T(inst2, inst2, weightY) );
-            fixedInstForceVecY_(inst2) += weightY * 
-              ( pin1->cy() - 
-                ( pin2->cy() - pin2->instance()->cy()) );
-          }
-          // pin1 from Instance / pin2 from IO port
-          else if( pin1->isPlaceInstConnected() 
-              && !pin2->isPlaceInstConnected() ) {
-            const int inst1 = pin1->instance()->extId();
-            listY.push_back( T(inst1, inst1, weightY) );
-            fixedInstForceVecY_(inst1) += weightY *
-              ( pin2->cy() -
-                ( pin1->cy() - pin1->instance()->cy()) );
-          }
+        if( pair.inst1 >= 0 && pair.inst2 >= 0 ) {
+          list.push_back( T(pair.inst1, pair.inst2, 1) );
+          list.push_back( T(pair.inst2, pair.inst1, 1) );
         }
       }
     }
-  } 
+  }
+
+  SMatrix pattern( placeCnt, placeCnt );
+  pattern.setFromTriplets(list.begin(), list.end());
+  patternTripletBytes_ = getCapacityBytes(list);
+  vector< T >().swap(list);
+
+  diagSlots_.resize(placeCnt);
+  for(int i=0; i<placeCnt; i++) {
+    diagSlots_[i] = getSlot(pattern, i, i);
+  }
+
+  for(auto& pair : b2bPairs_) {
+    if( pair.inst1 >= 0 && pair.inst2 >= 0 ) {
+      pair.slot12 = getSlot(pattern, pair.inst1, pair.inst2);
+      pair.slot21 = getSlot(pattern, pair.inst2, pair.inst1);
+    }
+  }
 
-  placeInstForceMatrixX_.setFromTriplets(listX.begin(), listX.end());
-  placeInstForceMatrixY_.setFromTriplets(listY.begin(), listY.end());
+  placeInstForceMatrixX_ = pattern;
+  placeInstForceMatrixY_ = pattern;
+
+  // Split b2bNets_ into contiguous chunks with similar pair counts,
+  // a few chunks per thread for load balancing
+  const int chunkCnt = std::max(1, 
+      std::min(getMaxThreads() * 4, static_cast<int>(b2bNets_.size())));
+  const size_t chunkPairCnt = pairCnt / chunkCnt + 1;
+
+  b2bNetChunkBegins_.assign(1, 0);
+  size_t curPairCnt = 0;
+  for(size_t i=0; i<b2bNets_.size(); i++) {
+    curPairCnt += getPinPairCnt(b2bNets_[i]->pins().size());
+    if( curPairCnt >= chunkPairCnt 
+        && static_cast<int>(b2bNetChunkBegins_.size()) < chunkCnt ) {
+      b2bNetChunkBegins_.push_back(i+1);
+      curPairCnt = 0;
+    }
+  }
+  b2bNetChunkBegins_.push_back(b2bNets_.size());
+
+  isSparsityPatternInit_ = true;
+}
+
+// B2B weights of each pin pair in pattern nets with current min/max pins.
+// Each pin pair is owned by exactly one net, 
+// so the chunks can be updated in parallel.
+void InitialPlace::updateB2BWeights() {
+  const int chunkCnt = b2bNetChunkBegins_.size() - 1;
+
+#pragma omp parallel for schedule(dynamic, 1)
+  for(int c=0; c<chunkCnt; c++) {
+    for(size_t i=b2bNetChunkBegins_[c]; i<b2bNetChunkBegins_[c+1]; i++) {
+      const Net* net = b2bNets_[i];
+      PointerRange<Pin> pins = net->pins();
+      
+      float netWeight = ipVars_.netWeightScale 
+        / (pins.size() - 1);
+
+      const size_t pairBegin = b2bPairBegins_[i];
+      const size_t pairEnd = b2bPairBegins_[i+1];
+      std::fill(b2bWeightsX_.begin() + pairBegin, 
+          b2bWeightsX_.begin() + pairEnd, 0.0f);
+      std::fill(b2bWeightsY_.begin() + pairBegin, 
+          b2bWeightsY_.begin() + pairEnd, 0.0f);
+
+      // B2B modeling on min/maxX pins.
+      forEachB2BPinPair(pins, &Pin::isMinPinX, &Pin::isMaxPinX,
+          [&](int pinIdx1, int pinIdx2) {
+        const size_t k = pairBegin + getPinPairIdx(pinIdx1, pinIdx2);
+        if( b2bPairs_[k].isValid() ) {
+          b2bWeightsX_[k] = getB2BWeight( 
+              abs(pins[pinIdx1]->cx() - pins[pinIdx2]->cx()), 
+              netWeight, ipVars_.minDiffLength );
+        }
+      });
+
+      // B2B modeling on min/maxY pins.
+      forEachB2BPinPair(pins, &Pin::isMinPinY, &Pin::isMaxPinY,
+          [&](int pinIdx1, int pinIdx2) {
+        const size_t k = pairBegin + getPinPairIdx(pinIdx1, pinIdx2);
+        if( b2bPairs_[k].isValid() ) {
+          b2bWeightsY_[k] = getB2BWeight( 
+              abs(pins[pinIdx1]->cy() - pins[pinIdx2]->cy()), 
+              netWeight, ipVars_.minDiffLength );
+        }
+      });
+    }
+  }
+}
+
+// solve placeInstForceMatrixX_ * xcg_x_ = xcg_b_ and placeInstForceMatrixY_ * ycg_x_ = ycg_b_ eq.
+void InitialPlace::createSparseMatrix() {
+  const int placeCnt = pb_->placeInsts().size();
+  instLocVecX_.resize( placeCnt );
+  fixedInstForceVecX_.resize( placeCnt );
+  instLocVecY_.resize( placeCnt );
+  fixedInstForceVecY_.resize( placeCnt );
+
+  // initialize vector
+  for(auto& inst : pb_->placeInsts()) {
+    int idx = inst->extId(); 
+    
+    instLocVecX_(idx) = inst->cx();
+    instLocVecY_(idx) = inst->cy();
+  }
+
+  if( !isSparsityPatternInit_ ) {
+    initSparsityPattern();
+  }
+
+  updateB2BWeights();
+
+  // overwrite X and Y values concurrently.
+  // Large nets are added on top of the pattern nets.
+#pragma omp parallel sections
+  {
+#pragma omp section
+    {
+      updateSparseMatrixValues(b2bNets_, b2bPairBegins_, b2bPairs_,
+          b2bWeightsX_, diagSlots_, &Pin::cx, &Instance::cx,
+          placeInstForceMatrixX_, fixedInstForceVecX_);
+      createLargeNetTriplets(b2bLargeNets_, ipVars_,
+          &Pin::isMinPinX, &Pin::isMaxPinX, &Pin::cx, &Instance::cx,
+          largeNetTripletsX_, fixedInstForceVecX_);
+    }
+#pragma omp section
+    {
+      updateSparseMatrixValues(b2bNets_, b2bPairBegins_, b2bPairs_,
+          b2bWeightsY_, diagSlots_, &Pin::cy, &Instance::cy,
+          placeInstForceMatrixY_, fixedInstForceVecY_);
+      createLargeNetTriplets(b2bLargeNets_, ipVars_,
+          &Pin::isMinPinY, &Pin::isMaxPinY, &Pin::cy, &Instance::cy,
+          largeNetTripletsY_, fixedInstForceVecY_);
+    }
+  }
+
+  if( b2bLargeNets_.empty() ) {
+    return;
+  }
+
+  // pairs of large nets that are not in the pattern yet.
+  // X and Y share the pattern, so both axes' pairs are added.
+  vector< T > newPairs;
+  for(auto list : {&largeNetTripletsX_, &largeNetTripletsY_}) {
+    for(auto& triplet : *list) {
+      if( getSlot(placeInstForceMatrixX_, 
+            triplet.row(), triplet.col()) < 0 ) {
+        newPairs.push_back( T(triplet.row(), triplet.col(), 0) );
+      }
+    }
+  }
+  if( !newPairs.empty() ) {
+    growSparsityPattern(newPairs);
+  }
+
+#pragma omp parallel sections
+  {
+#pragma omp section
+    addTripletValues(largeNetTripletsX_, placeInstForceMatrixX_);
+#pragma omp section
+    addTripletValues(largeNetTripletsY_, placeInstForceMatrixY_);
+  }
+}
+
+// Add zero-valued entries of newPairs to the pattern.
+// Current values are kept; slots are re-mapped to the new pattern.
+void InitialPlace::growSparsityPattern(const std::vector<T>& newPairs) {
+  const int placeCnt = pb_->placeInsts().size();
+  SMatrix newPattern( placeCnt, placeCnt );
+  newPattern.setFromTriplets(newPairs.begin(), newPairs.end());
+
+  placeInstForceMatrixX_ = placeInstForceMatrixX_ + newPattern;
+  placeInstForceMatrixY_ = placeInstForceMatrixY_ + newPattern;
+
+  for(int i=0; i<placeCnt; i++) {
+    diagSlots_[i] = getSlot(placeInstForceMatrixX_, i, i);
+  }
+
+  for(auto& pair : b2bPairs_) {
+    if( pair.inst1 >= 0 && pair.inst2 >= 0 ) {
+      pair.slot12 = getSlot(placeInstForceMatrixX_, pair.inst1, pair.inst2);
+      pair.slot21 = getSlot(placeInstForceMatrixX_, pair.inst2, pair.inst1);
+    }
+  }
 }
 
 void InitialPlace::updateCoordi() {
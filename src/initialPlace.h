@@ -4,11 +4,23 @@
 #include <Eigen/SparseCore>
 #include <opendb/db.h>
 #include <memory>
+#include <vector>
 
 namespace replace {
 
 class PlacerBase;
+class Net;
 class Logger;
+// iterative solvers for B2B matrix eqs.
+// B2B matrix is SPD, so CG can be used.
+enum class InitialPlaceSolver {
+  BiCGSTAB, CG
+};
+
+enum class InitialPlacePrecond {
+  None, Jacobi, IncompleteCholesky
+};
+
 class InitialPlaceVars {
 public:
   int maxIter;
@@ -17,6 +29,8 @@ public:
   int maxFanout;
   float netWeightScale;
   bool incrementalPlaceMode;
+  InitialPlaceSolver solver;
+  InitialPlacePrecond precond;
 
   InitialPlaceVars();
   void reset();
@@ -24,6 +38,21 @@ public:
 
 typedef Eigen::SparseMatrix<float, Eigen::RowMajor> SMatrix;
 
+// a pin pair in a net that can be modeled in B2B.
+// inst1/inst2 : extId of place instances. -1 if not placeable.
+// slot12/slot21 : index of (inst1, inst2)/(inst2, inst1) 
+//                 nonzeros in SMatrix::valuePtr(). -1 if not exist.
+class B2BPinPair {
+public:
+  int inst1;
+  int inst2;
+  int slot12;
+  int slot21;
+
+  B2BPinPair();
+  bool isValid() const { return (inst1 >= 0 || inst2 >= 0); }
+};
+
 class InitialPlace {
   public:
     InitialPlace();
@@ -34,6 +63,11 @@ class InitialPlace {
 
     void doBicgstabPlace();
 
+    // heap bytes of the matrices, vectors and B2B pattern.
+    // the largest triplet list of pattern assembly is included,
+    // though it is freed after assembly.
+    int64_t memoryBytes() const;
+
   private:
     InitialPlaceVars ipVars_;
     std::shared_ptr<PlacerBase> pb_;
@@ -59,16 +93,54 @@ class InitialPlace {
     // placeInstForceMatrixY_ :
     //        SparseMatrix that contains connectivity forces on Y // B2B model is used
     //
-    // Used the interative BiCGSTAB solver to solve matrix eqs.
+    // Used the interative BiCGSTAB or CG solver to solve matrix eqs.
+    // (See InitialPlaceVars::solver/precond)
 
     Eigen::VectorXf instLocVecX_, fixedInstForceVecX_;
     Eigen::VectorXf instLocVecY_, fixedInstForceVecY_;
     SMatrix placeInstForceMatrixX_, placeInstForceMatrixY_;
 
+    // Structure-reusing assembly.
+    //
+    // Between iterations, only B2B weights and min/max pins are changed.
+    // The union sparsity pattern of all pin pairs is built once, and 
+    // each iteration overwrites the values in place.
+    //
+    // b2bNets_ : nets that are modeled in B2B with the pattern.
+    // b2bPairs_ : lower-triangle pin pairs (pinIdx2 <= pinIdx1) 
+    //             of b2bNets_[i], starting from b2bPairBegins_[i].
+    // b2bWeightsX_/Y_ : B2B weights of b2bPairs_. 0 if not a B2B pair.
+    // diagSlots_ : index of diagonal nonzeros in SMatrix::valuePtr().
+    // b2bNetChunkBegins_ : b2bNets_ partition for parallel update.
+    std::vector<const Net*> b2bNets_;
+    std::vector<size_t> b2bPairBegins_;
+    std::vector<B2BPinPair> b2bPairs_;
+    std::vector<float> b2bWeightsX_, b2bWeightsY_;
+    std::vector<int> diagSlots_;
+    std::vector<size_t> b2bNetChunkBegins_;
+    bool isSparsityPatternInit_;
+    int64_t patternTripletBytes_;
+
+    // Nets with many pins don't use the pin pair index above,
+    // because the union pattern of all pin pairs is O(p^2).
+    // Their B2B pairs (O(p)) are collected on every iteration
+    // and added on placeInstForceMatrixX_/Y_ in place.
+    // The pattern grows with the pairs that are not in it yet,
+    // which stops once min/max pins settle down.
+    //
+    // b2bLargeNets_ : nets that are modeled in B2B without pin pair index.
+    // largeNetTripletsX_/Y_ : large nets' B2B of the current iteration.
+    std::vector<const Net*> b2bLargeNets_;
+    std::vector<Eigen::Triplet<float>> largeNetTripletsX_, largeNetTripletsY_;
+
     void placeInstsCenter();
     void setPlaceInstExtId();
     void updatePinInfo();
     void createSparseMatrix();
+    void initSparsityPattern();
+    void growSparsityPattern(
+        const std::vector<Eigen::Triplet<float>>& newPairs);
+    void updateB2BWeights();
     void updateCoordi();
     void reset();
 };
@@ -0,0 +1,158 @@
+#include "largeArray.h"
+#include "logger.h"
+#include "parallel.h"
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <new>
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+namespace replace {
+
+// transparent huge page size of x86-64/aarch64 (4KB base pages)
+static const size_t hugePageBytes = 2 * 1024 * 1024;
+
+static bool hugePage_ = false;
+static bool firstTouch_ = false;
+
+static std::atomic<int64_t> largeArrayBytes_(0);
+
+static size_t
+roundUp(size_t bytes, size_t unit) {
+  return (bytes + unit - 1) / unit * unit;
+}
+
+// true unless THP is "[never]" or not supported
+static bool
+isTransparentHugePageEnabled() {
+#ifdef MADV_HUGEPAGE
+  std::ifstream in("/sys/kernel/mm/transparent_hugepage/enabled");
+  std::string mode;
+  if( !std::getline(in, mode) ) {
+    return false;
+  }
+  return mode.find("[never]") == std::string::npos;
+#else
+  return false;
+#endif
+}
+
+// one write per page, partitioned as the kernels'
+// schedule(static) loops over the array.
+static void
+touchPages(char* ptr, size_t bytes) {
+  const int64_t pageBytes = sysconf(_SC_PAGESIZE);
+  const int64_t pageCnt = (bytes + pageBytes - 1) / pageBytes;
+#pragma omp parallel for schedule(static)
+  for(int64_t i=0; i<pageCnt; i++) {
+    ptr[i * pageBytes] = 0;
+  }
+}
+
+void
+setLargeArrayOptions(bool hugePage, bool firstTouch,
+    std::shared_ptr<Logger> log) {
+  if( hugePage && !isTransparentHugePageEnabled() ) {
+    log->warn("Transparent huge pages are disabled. "
+        "Huge pages are not used.", 10);
+    hugePage = false;
+  }
+  hugePage_ = hugePage;
+  firstTouch_ = firstTouch;
+
+  // default runs print nothing
+  if( !hugePage_ && !firstTouch_ ) {
+    return;
+  }
+  log->infoString("LargeArrayHugePage", (hugePage_)? "on" : "off");
+  log->infoString("LargeArrayFirstTouch", (firstTouch_)? "on" : "off");
+  if( firstTouch_ ) {
+    log->infoInt("FirstTouchThreads", getMaxThreads());
+  }
+}
+
+bool
+isLargeArrayHugePage() {
+  return hugePage_;
+}
+
+bool
+isLargeArrayFirstTouch() {
+  return firstTouch_;
+}
+
+int64_t
+getLargeArrayBytes() {
+  return largeArrayBytes_;
+}
+
+int64_t
+getHugePageBytes() {
+  std::ifstream in("/proc/self/smaps_rollup");
+  const std::string key = "AnonHugePages:";
+  std::string line;
+  while( std::getline(in, line) ) {
+    if( line.compare(0, key.size(), key) == 0 ) {
+      return std::stoll(line.substr(key.size())) * 1024;
+    }
+  }
+  return 0;
+}
+
+// Large arrays take roundUp(bytes, hugePageBytes) on a huge page
+// boundary. The mapping is decided by bytes only,
+// so freeLargeArray doesn't depend on the current options.
+void*
+allocateLargeArray(size_t bytes) {
+  if( bytes < largeArrayMinBytes ) {
+    return ::operator new(bytes);
+  }
+
+  const size_t arrayBytes = roundUp(bytes, hugePageBytes);
+  const size_t mapBytes = arrayBytes + hugePageBytes;
+  void* map = mmap(nullptr, mapBytes, PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if( map == MAP_FAILED ) {
+    throw std::bad_alloc();
+  }
+
+  // trim the unaligned head and the tail
+  char* mapBegin = static_cast<char*>(map);
+  char* ptr = reinterpret_cast<char*>(
+      roundUp(reinterpret_cast<uintptr_t>(mapBegin), hugePageBytes));
+  if( ptr != mapBegin ) {
+    munmap(mapBegin, ptr - mapBegin);
+  }
+  if( ptr + arrayBytes != mapBegin + mapBytes ) {
+    munmap(ptr + arrayBytes, (mapBegin + mapBytes) - (ptr + arrayBytes));
+  }
+  largeArrayBytes_ += arrayBytes;
+
+#ifdef MADV_HUGEPAGE
+  if( hugePage_ ) {
+    madvise(ptr, arrayBytes, MADV_HUGEPAGE);
+  }
+#endif
+
+  if( firstTouch_ ) {
+    touchPages(ptr, bytes);
+  }
+  return ptr;
+}
+
+void
+freeLargeArray(void* ptr, size_t bytes) {
+  if( bytes < largeArrayMinBytes ) {
+    ::operator delete(ptr);
+    return;
+  }
+
+  const size_t arrayBytes = roundUp(bytes, hugePageBytes);
+  munmap(ptr, arrayBytes);
+  largeArrayBytes_ -= arrayBytes;
+}
+
+}
@@ -0,0 +1,87 @@
+#ifndef __REPLACE_LARGE_ARRAY__
+#define __REPLACE_LARGE_ARRAY__
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace replace {
+
+class Logger;
+
+//
+// Backing memory of the placer's large arrays
+// (Nesterov per-gCell vectors, bins and FFT buffers).
+//
+// Arrays of at least largeArrayMinBytes are mapped directly
+// on huge page boundaries, so their pages are untouched until
+// first use. Optionally they are
+//
+//   hugePage   : advised as transparent huge pages (madvise),
+//   firstTouch : first-touched by OpenMP threads with
+//                schedule(static) over the array, i.e. the same
+//                partitioning as the kernels, so each page is placed
+//                on the NUMA node of the thread that works on it.
+//
+// Smaller arrays use operator new.
+//
+
+const size_t largeArrayMinBytes = 2 * 1024 * 1024;
+
+// Options of the following allocations; arrays already allocated
+// keep their placement. Prints the options to log if any is on.
+// hugePage is turned off with a warning if transparent huge pages
+// are disabled in the kernel.
+void setLargeArrayOptions(bool hugePage, bool firstTouch,
+    std::shared_ptr<Logger> log);
+
+bool isLargeArrayHugePage();
+bool isLargeArrayFirstTouch();
+
+// bytes currently mapped for large arrays
+int64_t getLargeArrayBytes();
+
+// bytes of this process backed by transparent huge pages
+// (AnonHugePages of /proc/self/smaps_rollup). 0 if unknown.
+int64_t getHugePageBytes();
+
+void* allocateLargeArray(size_t bytes);
+void freeLargeArray(void* ptr, size_t bytes);
+
+// std::vector allocator on allocateLargeArray, e.g.
+//
+//   std::vector<Bin, LargeArrayAllocator<Bin>> binStor_;
+//
+template <class T>
+class LargeArrayAllocator {
+public:
+  typedef T value_type;
+
+  LargeArrayAllocator() {}
+  template <class U>
+  LargeArrayAllocator(const LargeArrayAllocator<U>&) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(allocateLargeArray(n * sizeof(T)));
+  }
+  void deallocate(T* ptr, size_t n) {
+    freeLargeArray(ptr, n * sizeof(T));
+  }
+};
+
+// stateless; any two allocators can free each other's arrays
+template <class T, class U>
+inline bool operator==(const LargeArrayAllocator<T>&,
+    const LargeArrayAllocator<U>&) {
+  return true;
+}
+
+template <class T, class U>
+inline bool operator!=(const LargeArrayAllocator<T>&,
+    const LargeArrayAllocator<U>&) {
+  return false;
+}
+
+}
+
+#endif
@@ -1,91 +1,250 @@
 #include "logger.h"
 #include <iostream>
+#include <fstream>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <ctime>
+#include <algorithm>
 
-using std::cout;
-using std::endl;
-using std::string;
+#include <sys/resource.h>
 
-#define VERBOSE_CHECK() if( verbose_ < verbose ) { return; };
+using std::string;
 
 namespace replace {
 
 Logger::Logger(string name, int verbose)
-  : name_(name), verbose_(verbose) {}
+  : name_(name), verbose_(verbose) {
+  resetProfile();
+}
 
 // Procedure message
-void Logger::proc(string input, int verbose) {
-  VERBOSE_CHECK()
-  cout << "[PROC] " << input << endl;
-}
-void Logger::procBegin(string input, int verbose) {
-  VERBOSE_CHECK()
-  cout << "[PROC] Begin " << input << " ..." << endl;
-}
-void Logger::procEnd(string input, int verbose) {
-  VERBOSE_CHECK()
-  cout << "[PROC] End " << input << endl;
+void Logger::printProc(const char* prefix, const char* input,
+    const char* suffix) {
+  printf("[PROC] %s%s%s\n", prefix, input, suffix);
 }
 
 // Error message
-void Logger::error(string input, int code, int verbose) {
-  VERBOSE_CHECK()
-  cout << "[ERROR] " << input;
-  cout << " (" << name_ << "-" << code << ")" << endl;
+void Logger::printError(const char* input, int code) {
+  printf("[ERROR] %s (%s-%d)\n", input, name_.c_str(), code);
+  flush();
   exit(code);
 }
 
-void Logger::warn(string input, int code, int verbose) {
-  VERBOSE_CHECK()
-  cout << "[WARN] " << input;
-  cout << " (" << name_ << "-" << code << ")" << endl;
+void Logger::printWarn(const char* input, int code) {
+  printf("[WARN] %s (%s-%d)\n", input, name_.c_str(), code);
+  flush();
 }
 
 // Info message
-void Logger::infoInt(string input, int val, int verbose) {
-  VERBOSE_CHECK()
-  cout << "[INFO] " << input << " = " << val << endl;
+void Logger::printInt64(const char* input, int64_t val) {
+  printf("[INFO] %s = %lld\n", input, static_cast<long long>(val));
 }
-void Logger::infoIntPair(string input, int val1, int val2, int verbose) {
-  VERBOSE_CHECK()
-  cout << "[INFO] " << input << " = (" << val1 << ", " << val2 << ")" << endl;
+
+void Logger::printIntPair(const char* input, int val1, int val2) {
+  printf("[INFO] %s = (%d, %d)\n", input, val1, val2);
 }
 
-void Logger::infoInt64(string input, int64_t val, int verbose) {
-  VERBOSE_CHECK()
-  cout << "[INFO] " << input << " = " << val << endl;
+void Logger::printFloat(const char* input, float val, bool isSignificant) {
+  if( isSignificant ) {
+    printf("[INFO] %s = %g\n", input, val);
+  }
+  else {
+    printf("[INFO] %s = %.6f\n", input, val);
+  }
 }
 
+void Logger::printFloatPair(const char* input, float val1, float val2) {
+  printf("[INFO] %s = (%.6f, %.6f)\n", input, val1, val2);
+}
 
-void Logger::infoFloat(string input, float val, int verbose) {
-  VERBOSE_CHECK()
-  printf("[INFO] %s = %.6f\n", input.c_str(), val);
-  fflush(stdout);
+void Logger::printString(const char* input, const char* val) {
+  if( val ) {
+    printf("[INFO] %s = %s\n", input, val);
+  }
+  else {
+    printf("[INFO] %s\n", input);
+  }
 }
-// SI format due to WNS/TNS
-void Logger::infoFloatSignificant(string input, float val, int verbose) {
-  VERBOSE_CHECK()
-  printf("[INFO] %s = %g\n", input.c_str(), val);
-  fflush(stdout);
+
+void Logger::printRuntime(const char* input, double runtime) {
+  printf("[INFO] %sRuntime = %.4f\n", input, runtime);
 }
 
-void Logger::infoFloatPair(string input, float val1, float val2, int verbose) {
-  VERBOSE_CHECK()
-  printf("[INFO] %s = (%.6f, %.6f)\n", input.c_str(), val1, val2);
+void Logger::printMemory(const char* input, int64_t bytes) {
+  printf("[INFO] %sMemory = %.2f MB\n", input, bytes / 1048576.0);
+}
+
+void Logger::flush() {
   fflush(stdout);
 }
-void Logger::infoString(string input, int verbose) {
-  VERBOSE_CHECK()
-  cout << "[INFO] " << input << endl;
+
+////////////////////////////////////////////////////////
+// Phase profiler
+
+static double
+getWallTime() {
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
 }
-void Logger::infoString(string input, string val, int verbose) {
-  VERBOSE_CHECK()
-  cout << "[INFO] " << input << " = " << val << endl;
+
+// CPU time of all threads, so that CPU/wall shows the parallelism.
+static double
+getCpuTime() {
+  timespec ts;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
 }
-void Logger::infoRuntime(string input, double runtime, int verbose) {
-  VERBOSE_CHECK()
-  printf("[INFO] %sRuntime = %.4f\n", input.c_str(), runtime);
-  fflush(stdout);
+
+Logger::ProfilePhase::ProfilePhase(const char* name, int parent)
+  : name(name), parent(parent), calls(0),
+  wallTime(0), cpuTime(0), peakRss(0), wallBegin(0), cpuBegin(0) {}
+
+// ru_maxrss is in KB on Linux
+int64_t Logger::getPeakRssBytes() {
+  rusage usage;
+  if( getrusage(RUSAGE_SELF, &usage) != 0 ) {
+    return 0;
+  }
+  return static_cast<int64_t>(usage.ru_maxrss) * 1024;
+}
+
+void Logger::resetProfile() {
+  profilePhases_.clear();
+  profilePhases_.push_back(ProfilePhase("Total", -1));
+  curProfilePhase_ = 0;
+}
+
+void Logger::profileBegin(const char* phase) {
+  // phase names are literals; compare pointers first.
+  int child = -1;
+  for(int idx : profilePhases_[curProfilePhase_].children) {
+    const char* name = profilePhases_[idx].name;
+    if( name == phase || strcmp(name, phase) == 0 ) {
+      child = idx;
+      break;
+    }
+  }
+
+  if( child == -1 ) {
+    child = profilePhases_.size();
+    profilePhases_.push_back(ProfilePhase(phase, curProfilePhase_));
+    profilePhases_[curProfilePhase_].children.push_back(child);
+  }
+
+  ProfilePhase& profilePhase = profilePhases_[child];
+  profilePhase.calls++;
+  profilePhase.wallBegin = getWallTime();
+  profilePhase.cpuBegin = getCpuTime();
+  curProfilePhase_ = child;
+}
+
+double Logger::profileWallTime(const char* phase) const {
+  double wallTime = 0;
+  for(auto& profilePhase : profilePhases_) {
+    if( profilePhase.name == phase 
+        || strcmp(profilePhase.name, phase) == 0 ) {
+      wallTime += profilePhase.wallTime;
+    }
+  }
+  return wallTime;
+}
+
+void Logger::profileEnd() {
+  // unbalanced profileEnd() is ignored.
+  if( curProfilePhase_ == 0 ) {
+    return;
+  }
+  ProfilePhase& profilePhase = profilePhases_[curProfilePhase_];
+  profilePhase.wallTime += getWallTime() - profilePhase.wallBegin;
+  profilePhase.cpuTime += getCpuTime() - profilePhase.cpuBegin;
+  profilePhase.peakRss = std::max(profilePhase.peakRss, getPeakRssBytes());
+  curProfilePhase_ = profilePhase.parent;
+}
+
+void Logger::reportProfile(int verbose) {
+  if( !isEnabled(verbose) ) {
+    return;
+  }
+  printf("[INFO] %-36s %10s %10s %10s %7s %12s\n",
+      "Phase", "Wall(s)", "CPU(s)", "Calls", "Wall%", "PeakRSS(MB)");
+  for(int child : profilePhases_[0].children) {
+    reportProfilePhase(child, 0);
+  }
+  flush();
+}
+
+// Wall% is relative to the parent phase
+void Logger::reportProfilePhase(int phase, int depth) {
+  const ProfilePhase& profilePhase = profilePhases_[phase];
+  const ProfilePhase& parent = profilePhases_[profilePhase.parent];
+
+  string name = string(2 * depth, ' ') + profilePhase.name;
+  const double peakRss = profilePhase.peakRss / 1048576.0;
+  if( profilePhase.parent == 0 ) {
+    printf("[INFO] %-36s %10.4f %10.4f %10lld %7s %12.1f\n",
+        name.c_str(), profilePhase.wallTime, profilePhase.cpuTime,
+        static_cast<long long>(profilePhase.calls), "-", peakRss);
+  }
+  else {
+    const double ratio = (parent.wallTime > 0)? 
+      100.0 * profilePhase.wallTime / parent.wallTime : 0;
+    printf("[INFO] %-36s %10.4f %10.4f %10lld %7.1f %12.1f\n",
+        name.c_str(), profilePhase.wallTime, profilePhase.cpuTime,
+        static_cast<long long>(profilePhase.calls), ratio, peakRss);
+  }
+
+  for(int child : profilePhase.children) {
+    reportProfilePhase(child, depth + 1);
+  }
+}
+
+bool Logger::writeProfileJson(const string& fileName) {
+  std::ofstream out(fileName);
+  if( !out.good() ) {
+    return false;
+  }
+  writeProfileJsonPhase(out, 0, 0);
+  out << "\n";
+  return out.good();
+}
+
+void Logger::writeProfileJsonPhase(std::ostream& out, int phase, int depth) {
+  const ProfilePhase& profilePhase = profilePhases_[phase];
+  const string indent(2 * depth, ' ');
+
+  // root holds the sum of top-level phases
+  double wallTime = profilePhase.wallTime;
+  double cpuTime = profilePhase.cpuTime;
+  int64_t peakRss = profilePhase.peakRss;
+  if( phase == 0 ) {
+    for(int child : profilePhase.children) {
+      wallTime += profilePhases_[child].wallTime;
+      cpuTime += profilePhases_[child].cpuTime;
+      peakRss = std::max(peakRss, profilePhases_[child].peakRss);
+    }
+  }
+
+  char buf[256];
+  snprintf(buf, sizeof(buf), 
+      "\"wall\": %.6f, \"cpu\": %.6f, \"calls\": %lld, "
+      "\"peak_rss_mb\": %.1f",
+      wallTime, cpuTime, static_cast<long long>(profilePhase.calls),
+      peakRss / 1048576.0);
+
+  out << indent << "{\"name\": \"" << profilePhase.name << "\", " << buf;
+  if( profilePhase.children.empty() ) {
+    out << "}";
+    return;
+  }
+
+  out << ", \"children\": [\n";
+  for(size_t i=0; i<profilePhase.children.size(); i++) {
+    writeProfileJsonPhase(out, profilePhase.children[i], depth + 1);
+    out << ((i+1 < profilePhase.children.size())? ",\n" : "\n");
+  }
+  out << indent << "]}";
 }
 
 }
@@ -2,42 +2,191 @@
 #define __REPLACE_LOGGER__
 
 #include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <iosfwd>
 
 namespace replace {
 
-class Logger {
+// heap bytes held by vec (capacity, not size)
+template <class T, class Alloc>
+inline int64_t getCapacityBytes(const std::vector<T, Alloc>& vec) {
+  return static_cast<int64_t>(vec.capacity()) * sizeof(T);
+}
 
+// Message text of Logger.
+// Literals are kept as pointers, so messages filtered out
+// by verbose never build std::string temporaries.
+class LogText {
 public:
-  Logger(std::string name, int verbose);
+  LogText(const char* str) : str_(str) {}
+  LogText(const std::string& str) : str_(str.c_str()) {}
+  const char* c_str() const { return str_; }
 
-  // Print functions
-  void proc(std::string input, int verbose = 0);
-  void procBegin(std::string input, int verbose = 0);
-  void procEnd(std::string input, int verbose = 0);
+private:
+  const char* str_;
+};
 
-  void error(std::string input, int code, int verbose = 0); 
+class Logger {
 
-  void warn(std::string input, int code, int verbose = 0);
+public:
+  Logger(std::string name, int verbose);
 
-  void infoInt(std::string input, int val, int verbose = 0);
-  void infoIntPair(std::string input, int val1, int val2, int verbose = 0);
-  
-  void infoInt64(std::string input, int64_t val, int verbose = 0);
+  // True if messages of the verbose level are printed.
+  // Guard arguments that are expensive to compute, e.g.
+  //
+  //   if( log_->isEnabled(3) ) {
+  //     log_->infoFloatSignificant("Gradient", getSecondNorm(grads), 3);
+  //   }
+  bool isEnabled(int verbose) const { return verbose <= verbose_; }
 
-  void infoFloat(std::string input, float val, int verbose = 0);
-  void infoFloatSignificant(std::string input, float val, int verbose = 0);
-  void infoFloatPair(std::string input, float val1, float val2, int verbose = 0);
+  // Print functions
+  //
+  // The verbose check is inlined; a filtered message costs
+  // one branch and is never formatted.
+  // Messages go through the stdio buffer and are flushed on
+  // procEnd(), warn(), error() and flush().
+  void proc(LogText input, int verbose = 0) {
+    if( isEnabled(verbose) ) { printProc("", input.c_str(), ""); }
+  }
+  void procBegin(LogText input, int verbose = 0) {
+    if( isEnabled(verbose) ) { printProc("Begin ", input.c_str(), " ..."); }
+  }
+  void procEnd(LogText input, int verbose = 0) {
+    if( isEnabled(verbose) ) {
+      printProc("End ", input.c_str(), "");
+      flush();
+    }
+  }
+
+  void error(LogText input, int code, int verbose = 0) {
+    if( isEnabled(verbose) ) { printError(input.c_str(), code); }
+  }
+
+  void warn(LogText input, int code, int verbose = 0) {
+    if( isEnabled(verbose) ) { printWarn(input.c_str(), code); }
+  }
+
+  void infoInt(LogText input, int val, int verbose = 0) {
+    if( isEnabled(verbose) ) { printInt64(input.c_str(), val); }
+  }
+  void infoIntPair(LogText input, int val1, int val2, int verbose = 0) {
+    if( isEnabled(verbose) ) { printIntPair(input.c_str(), val1, val2); }
+  }
+
+  void infoInt64(LogText input, int64_t val, int verbose = 0) {
+    if( isEnabled(verbose) ) { printInt64(input.c_str(), val); }
+  }
+
+  void infoFloat(LogText input, float val, int verbose = 0) {
+    if( isEnabled(verbose) ) { printFloat(input.c_str(), val, false); }
+  }
+  // SI format due to WNS/TNS
+  void infoFloatSignificant(LogText input, float val, int verbose = 0) {
+    if( isEnabled(verbose) ) { printFloat(input.c_str(), val, true); }
+  }
+  void infoFloatPair(LogText input, float val1, float val2, int verbose = 0) {
+    if( isEnabled(verbose) ) { printFloatPair(input.c_str(), val1, val2); }
+  }
+
+  void infoString(LogText input, int verbose = 0) {
+    if( isEnabled(verbose) ) { printString(input.c_str(), nullptr); }
+  }
+  void infoString(LogText input, LogText val, int verbose = 0) {
+    if( isEnabled(verbose) ) { printString(input.c_str(), val.c_str()); }
+  }
+
+  void infoRuntime(LogText input, double runtime, int verbose = 0) {
+    if( isEnabled(verbose) ) { printRuntime(input.c_str(), runtime); }
+  }
+
+  // bytes are printed in MB
+  void infoMemory(LogText input, int64_t bytes, int verbose = 0) {
+    if( isEnabled(verbose) ) { printMemory(input.c_str(), bytes); }
+  }
+
+  // flush buffered messages (e.g. at the end of a command)
+  void flush();
+
+  // Phase profiler (See ProfileScope).
+  // Phases nest in call order (e.g. NesterovPlace/BackTracking/DensityFFT)
+  // and accumulate wall/CPU time and call counts per call path.
+  // Peak RSS is sampled at the end of each phase.
+  // Phases must be opened outside of OpenMP parallel regions.
+  void profileBegin(const char* phase);
+  void profileEnd();
+
+  // Print the phase table.
+  void reportProfile(int verbose = 0);
+
+  // returns false on I/O errors.
+  bool writeProfileJson(const std::string& fileName);
+  void resetProfile();
+
+  // wall time in seconds of the closed calls of a phase,
+  // summed over all call paths of the phase.
+  double profileWallTime(const char* phase) const;
+
+  // peak resident set size of this process so far
+  static int64_t getPeakRssBytes();
 
-  void infoString(std::string input, int verbose = 0);
-  void infoString(std::string input, std::string val, int verbose = 0);
+private:
+  int verbose_;
+  std::string name_;
 
-  void infoRuntime(std::string input, double runtime, int verbose = 0);
+  // out-of-line printers of the Print functions
+  void printProc(const char* prefix, const char* input, const char* suffix);
+  void printError(const char* input, int code);
+  void printWarn(const char* input, int code);
+  void printInt64(const char* input, int64_t val);
+  void printIntPair(const char* input, int val1, int val2);
+  void printFloat(const char* input, float val, bool isSignificant);
+  void printFloatPair(const char* input, float val1, float val2);
+  void printString(const char* input, const char* val);
+  void printRuntime(const char* input, double runtime);
+  void printMemory(const char* input, int64_t bytes);
+
+  class ProfilePhase {
+  public:
+    const char* name;
+    int parent;
+    std::vector<int> children;
+    int64_t calls;
+    double wallTime;
+    double cpuTime;
+    int64_t peakRss;
+    double wallBegin;
+    double cpuBegin;
+
+    ProfilePhase(const char* name, int parent);
+  };
+
+  // profilePhases_[0] is the root
+  std::vector<ProfilePhase> profilePhases_;
+  int curProfilePhase_;
+
+  void reportProfilePhase(int phase, int depth);
+  void writeProfileJsonPhase(std::ostream& out, int phase, int depth);
+};
 
+// Times the enclosing scope as a phase of log.
+//
+//   {
+//     ProfileScope scope(log_, "DensityFFT");
+//     ...
+//   }
+class ProfileScope {
+public:
+  ProfileScope(const std::shared_ptr<Logger>& log, const char* phase)
+    : log_(log.get()) { log_->profileBegin(phase); }
+  ~ProfileScope() { log_->profileEnd(); }
 
 private:
-  int verbose_;
-  std::string name_;
+  Logger* log_;
 
+  ProfileScope(const ProfileScope&) = delete;
+  ProfileScope& operator=(const ProfileScope&) = delete;
 };
 
 }
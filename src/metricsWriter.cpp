@@ -0,0 +1,165 @@
+#include "metricsWriter.h"
+
+#include <chrono>
+#include <cmath>
+
+namespace replace {
+
+using namespace std;
+
+// records; 2000 Nesterov iterations fit without wrapping.
+static const size_t ringSize = 1 << 12;
+
+// writer wake-up period while the ring is empty
+static const int writerSleepMs = 5;
+
+IterMetrics::IterMetrics()
+  : iter(0), overflow(0), hpwl(0),
+  stepLength(0), densityPenalty(0), backTrackCnt(0),
+  wireLengthGradSum(0), densityGradSum(0), gradNorm(0),
+  backTrackTime(0), updateNextIterTime(0), iterTime(0),
+  densityAreaTime(0), densityFFTTime(0), 
+  wireLengthTime(0), gradientTime(0) {}
+
+MetricsWriter::MetricsWriter()
+  : format_(Format::JsonLines),
+  ring_(ringSize),
+  head_(0), tail_(0), isStopped_(false) {}
+
+MetricsWriter::~MetricsWriter() {
+  close();
+}
+
+static bool
+isCsvFile(const string& fileName) {
+  const string ext = ".csv";
+  return fileName.size() >= ext.size()
+    && fileName.compare(fileName.size() - ext.size(),
+        ext.size(), ext) == 0;
+}
+
+bool
+MetricsWriter::open(const string& fileName) {
+  close();
+  out_.open(fileName);
+  if( !out_.good() ) {
+    return false;
+  }
+
+  format_ = (isCsvFile(fileName))? Format::Csv : Format::JsonLines;
+  if( format_ == Format::Csv ) {
+    out_ << "iter,overflow,hpwl,step_length,density_penalty,"
+      << "backtracks,wirelength_grad_sum,density_grad_sum,grad_norm,"
+      << "backtrack_ms,update_next_iter_ms,iter_ms,"
+      << "density_area_ms,density_fft_ms,wirelength_ms,gradient_ms\n";
+  }
+
+  head_ = tail_ = 0;
+  isStopped_ = false;
+  thread_ = std::thread(&MetricsWriter::run, this);
+  return true;
+}
+
+void
+MetricsWriter::close() {
+  if( !thread_.joinable() ) {
+    return;
+  }
+  isStopped_.store(true, memory_order_release);
+  thread_.join();
+  out_.close();
+}
+
+void
+MetricsWriter::push(const IterMetrics& metrics) {
+  const uint64_t tail = tail_.load(memory_order_relaxed);
+
+  // full ring; the writer is behind the file system.
+  while( tail - head_.load(memory_order_acquire) >= ring_.size() ) {
+    std::this_thread::yield();
+  }
+
+  ring_[tail & (ring_.size() - 1)] = metrics;
+  tail_.store(tail + 1, memory_order_release);
+}
+
+void
+MetricsWriter::run() {
+  while( true ) {
+    // read the flag before draining,
+    // so that records pushed before close() are not lost.
+    const bool isStopped = isStopped_.load(memory_order_acquire);
+    if( writeAll() > 0 ) {
+      out_.flush();
+    }
+    else if( isStopped ) {
+      break;
+    }
+    else {
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(writerSleepMs));
+    }
+  }
+}
+
+int
+MetricsWriter::writeAll() {
+  const uint64_t head = head_.load(memory_order_relaxed);
+  const uint64_t tail = tail_.load(memory_order_acquire);
+  for(uint64_t i=head; i<tail; i++) {
+    write(ring_[i & (ring_.size() - 1)]);
+  }
+  head_.store(tail, memory_order_release);
+  return static_cast<int>(tail - head);
+}
+
+// JSON has no nan/inf (e.g. diverged iterations)
+static void
+writeJsonNumber(ofstream& out, double val) {
+  if( std::isfinite(val) ) {
+    out << val;
+  }
+  else {
+    out << "null";
+  }
+}
+
+void
+MetricsWriter::write(const IterMetrics& m) {
+  if( format_ == Format::Csv ) {
+    out_ << m.iter << "," << m.overflow << "," << m.hpwl << ","
+      << m.stepLength << "," << m.densityPenalty << ","
+      << m.backTrackCnt << "," << m.wireLengthGradSum << ","
+      << m.densityGradSum << "," << m.gradNorm << ","
+      << m.backTrackTime << "," << m.updateNextIterTime << ","
+      << m.iterTime << "," << m.densityAreaTime << ","
+      << m.densityFFTTime << "," << m.wireLengthTime << ","
+      << m.gradientTime << "\n";
+  }
+  else {
+    out_ << "{\"iter\": " << m.iter;
+    out_ << ", \"overflow\": ";
+    writeJsonNumber(out_, m.overflow);
+    out_ << ", \"hpwl\": " << m.hpwl;
+    out_ << ", \"step_length\": ";
+    writeJsonNumber(out_, m.stepLength);
+    out_ << ", \"density_penalty\": ";
+    writeJsonNumber(out_, m.densityPenalty);
+    out_ << ", \"backtracks\": " << m.backTrackCnt;
+    out_ << ", \"wirelength_grad_sum\": ";
+    writeJsonNumber(out_, m.wireLengthGradSum);
+    out_ << ", \"density_grad_sum\": ";
+    writeJsonNumber(out_, m.densityGradSum);
+    out_ << ", \"grad_norm\": ";
+    writeJsonNumber(out_, m.gradNorm);
+    out_ << ", \"backtrack_ms\": " << m.backTrackTime;
+    out_ << ", \"update_next_iter_ms\": " << m.updateNextIterTime;
+    out_ << ", \"iter_ms\": " << m.iterTime;
+    out_ << ", \"density_area_ms\": " << m.densityAreaTime;
+    out_ << ", \"density_fft_ms\": " << m.densityFFTTime;
+    out_ << ", \"wirelength_ms\": " << m.wireLengthTime;
+    out_ << ", \"gradient_ms\": " << m.gradientTime << "}\n";
+  }
+}
+
+}
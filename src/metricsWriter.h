@@ -0,0 +1,96 @@
+#ifndef __REPLACE_METRICS_WRITER__
+#define __REPLACE_METRICS_WRITER__
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <cstdint>
+
+namespace replace {
+
+// One Nesterov iteration (See NesterovPlace::doNesterovPlace)
+class IterMetrics {
+public:
+  int iter;
+  float overflow;
+  int64_t hpwl;
+  float stepLength;
+  float densityPenalty;
+  int backTrackCnt;
+  float wireLengthGradSum;
+  float densityGradSum;
+  // second norm of the preconditioned sum gradient
+  float gradNorm;
+
+  // wall time in ms
+  double backTrackTime;
+  double updateNextIterTime;
+  double iterTime;
+
+  // wall time in ms of the profiler phases in backTrackTime,
+  // summed over the backtracking steps
+  double densityAreaTime;
+  double densityFFTTime;
+  double wireLengthTime;
+  double gradientTime;
+
+  IterMetrics();
+};
+
+//
+// Streams IterMetrics to a file from a background thread,
+// so that the Nesterov loop only copies a record per iteration.
+//
+// push() must be called from a single thread;
+// records go through a single-producer/single-consumer ring
+// without locks. The writer flushes after every batch,
+// so the file can be followed (e.g. tail -f) during the run.
+//
+// File format is CSV for "*.csv", JSON Lines otherwise.
+//
+class MetricsWriter {
+public:
+  MetricsWriter();
+  ~MetricsWriter();
+
+  // returns false when the file cannot be opened.
+  bool open(const std::string& fileName);
+
+  // waits until every pushed record is written.
+  void close();
+
+  bool isOpen() const { return thread_.joinable(); }
+
+  void push(const IterMetrics& metrics);
+
+private:
+  enum class Format {
+    JsonLines,
+    Csv
+  };
+
+  std::ofstream out_;
+  Format format_;
+  std::thread thread_;
+
+  // ring of capacity 2^n.
+  // head_ is owned by the writer, tail_ by push().
+  std::vector<IterMetrics> ring_;
+  std::atomic<uint64_t> head_;
+  std::atomic<uint64_t> tail_;
+  std::atomic<bool> isStopped_;
+
+  void run();
+  // returns the number of written records
+  int writeAll();
+  void write(const IterMetrics& metrics);
+
+  MetricsWriter(const MetricsWriter&) = delete;
+  MetricsWriter& operator=(const MetricsWriter&) = delete;
+};
+
+}
+
+#endif
@@ -34,6 +34,17 @@ getOverlapDensityArea(Bin* bin, GCell* cell);
 static float
 fastExp(float exp);
 
+static uint64_t
+getHilbertKey(uint32_t x, uint32_t y);
+
+static GCell
+getInstGCell(Instance* const* placeInst, int siteSizeY);
+
+template <class T, class GT, class Index>
+static std::vector<int>
+compactGObjects(const std::vector<T*>& list, 
+    const std::vector<GT*>& idMap, std::vector<GT>& gStor, Index index);
+
 
 ////////////////////////////////////////////////
 // GCell 
@@ -45,14 +56,14 @@ GCell::GCell()
   gradientX_(0), gradientY_(0) {}
 
 
-GCell::GCell(Instance* inst) 
-  : GCell() {
-  setInstance(inst);
-}
-
-GCell::GCell(std::vector<Instance*>& insts) 
+GCell::GCell(PointerRange<Instance> insts) 
   : GCell() {
-  setClusteredInstance(insts);
+  if( insts.size() == 1 ) {
+    setInstance(insts);
+  }
+  else {
+    setClusteredInstance(insts);
+  }
 }
 
 GCell::GCell(int cx, int cy, int dx, int dy) 
@@ -64,13 +75,10 @@ GCell::GCell(int cx, int cy, int dx, int dy)
   setFiller();
 }
 
-GCell::~GCell() {
-  insts_.clear();
-}
-
 void
-GCell::setInstance(Instance* inst) {
-  insts_.push_back(inst);
+GCell::setInstance(PointerRange<Instance> insts) {
+  insts_ = insts;
+  Instance* inst = insts[0];
   // density coordi has the same center points.
   dLx_ = lx_ = inst->lx();
   dLy_ = ly_ = inst->ly();
@@ -84,8 +92,8 @@ GCell::instance() const {
 }
 
 void
-GCell::addGPin(GPin* gPin) {
-  gPins_.push_back(gPin);
+GCell::setGPins(PointerRange<GPin> gPins) {
+  gPins_ = gPins;
 }
 
 
@@ -95,7 +103,7 @@ GCell::setFiller() {
 }
 
 void
-GCell::setClusteredInstance(std::vector<Instance*>& insts) {
+GCell::setClusteredInstance(PointerRange<Instance> insts) {
   insts_ = insts;
 }
 
@@ -242,19 +250,10 @@ GNet::GNet()
   waExpMaxSumY_(0), waYExpMaxSumY_(0),
   isDontCare_(0) {}
 
-GNet::GNet(Net* net) : GNet() {
-  nets_.push_back(net);
-}
-
-GNet::GNet(std::vector<Net*>& nets) : GNet() {
+GNet::GNet(PointerRange<Net> nets) : GNet() {
   nets_ = nets;
 }
 
-GNet::~GNet() {
-  gPins_.clear();
-  nets_.clear();
-}
-
 Net* 
 GNet::net() const { 
   return *nets_.begin();
@@ -266,8 +265,8 @@ GNet::setCustomWeight(float customWeight) {
 }
 
 void
-GNet::addGPin(GPin* gPin) {
-  gPins_.push_back(gPin);
+GNet::setGPins(PointerRange<GPin> gPins) {
+  gPins_ = gPins;
 }
 
 void
@@ -326,25 +325,16 @@ GPin::GPin()
   hasMaxExpSumX_(0), hasMaxExpSumY_(0), 
   hasMinExpSumX_(0), hasMinExpSumY_(0) {}
 
-GPin::GPin(Pin* pin)
+GPin::GPin(PointerRange<Pin> pins)
   : GPin() {
-  pins_.push_back(pin);
+  pins_ = pins;
+  Pin* pin = pins[0];
   cx_ = pin->cx();
   cy_ = pin->cy();
   offsetCx_ = pin->offsetCx();
   offsetCy_ = pin->offsetCy();
 }
 
-GPin::GPin(std::vector<Pin*> & pins) {
-  pins_ = pins;
-}
-
-GPin::~GPin() {
-  gCell_ = nullptr;
-  gNet_ = nullptr;
-  pins_.clear();
-}
-
 Pin* 
 GPin::pin() const {
   return *pins_.begin();
@@ -478,6 +468,19 @@ Bin::electroPhi() const {
   return electroPhi_;
 }
 
+////////////////////////////////////////////////
+// FillerDensity
+
+FillerDensity::FillerDensity()
+  : dDx(0), dDy(0), densityScale(0) {}
+
+void
+InstDensityCells::clear() {
+  macros.clear();
+  stdCells.clear();
+  scaledStdCells.clear();
+}
+
 void
 Bin::setDensity(float density) {
   density_ = density;
@@ -523,6 +526,11 @@ BinGrid::~BinGrid() {
   overflowArea_ = 0;
 }
 
+int64_t
+BinGrid::memoryBytes() const {
+  return getCapacityBytes(binStor_) + getCapacityBytes(bins_);
+}
+
 void
 BinGrid::setCoordi(Die* die) {
   lx_ = die->coreLx();
@@ -564,6 +572,11 @@ BinGrid::setBinCntY(int binCntY) {
   binCntY_ = binCntY;
 }
 
+void
+BinGrid::unsetBinCnt() {
+  isSetBinCntX_ = isSetBinCntY_ = 0;
+}
+
 int
 BinGrid::lx() const {
   return lx_;
@@ -680,6 +693,7 @@ BinGrid::initBins() {
 
   // initialize binStor_, bins_ vector
   binStor_.resize(binCntX_ * binCntY_);
+  bins_.clear();
   bins_.reserve(binCntX_ * binCntY_);
   int x = lx_, y = ly_;
   int idxX = 0, idxY = 0;
@@ -741,61 +755,89 @@ BinGrid::updateBinsNonPlaceArea() {
 }
 
 
+// The following kernel is critical runtime hotspot 
+// for global placer.
+//
+// cellClass is a template argument, so each class is compiled 
+// without branches. The clamped overlap is the same as 
+// getOverlapDensityArea, and bins are read from binStor_ 
+// (bins_[k] is &binStor_[k]).
+//
+// Each add is truncated to int64_t as before,
+// so the bin areas don't depend on the cell order.
+template <DensityCellClass cellClass>
+inline void
+BinGrid::addDensityArea(int dLx, int dLy, int dUx, int dUy, 
+    float scale) {
+  std::pair<int, int> pairX 
+    = getDensityMinMaxIdxX(dLx, dUx);
+  std::pair<int, int> pairY 
+    = getDensityMinMaxIdxY(dLy, dUy);
+
+  for(int i = pairX.first; i < pairX.second; i++) {
+    for(int j = pairY.first; j < pairY.second; j++) {
+      Bin& bin = binStor_[ j * binCntX_ + i ];
+      const float overlapX = static_cast<float>( 
+          max(0, min(bin.ux(), dUx) - max(bin.lx(), dLx)) );
+      const float overlapY = static_cast<float>( 
+          max(0, min(bin.uy(), dUy) - max(bin.ly(), dLy)) );
+      const float area = overlapX * overlapY;
+
+      // macro should have 
+      // scale-down with target-density
+      if( cellClass == DensityCellClass::Macro ) {
+        bin.addInstPlacedArea( area * scale * bin.targetDensity() );
+      }
+      else if( cellClass == DensityCellClass::Std ) {
+        bin.addInstPlacedArea( area );
+      }
+      else if( cellClass == DensityCellClass::ScaledStd ) {
+        bin.addInstPlacedArea( area * scale );
+      }
+      else {
+        bin.addFillerArea( area * scale );
+      }
+    }
+  }
+}
+
 // Core Part
 void
 BinGrid::updateBinsGCellDensityArea(
-    std::vector<GCell*>& cells) {
+    const InstDensityCells& cells,
+    const FillerDensity& fillers) {
+  ProfileScope scope(log_, "DensityArea");
+
   // clear the Bin-area info
   for(auto& bin : bins_) {
     bin->setInstPlacedArea(0);
     bin->setFillerArea(0);
   }
 
-  for(auto& cell : cells) {
-    std::pair<int, int> pairX 
-      = getDensityMinMaxIdxX(cell);
-    std::pair<int, int> pairY 
-      = getDensityMinMaxIdxY(cell);
+  for(auto& cell : cells.macros) {
+    addDensityArea<DensityCellClass::Macro>(
+        cell->dLx(), cell->dLy(), cell->dUx(), cell->dUy(),
+        cell->densityScale());
+  }
+  for(auto& cell : cells.stdCells) {
+    addDensityArea<DensityCellClass::Std>(
+        cell->dLx(), cell->dLy(), cell->dUx(), cell->dUy(), 1.0f);
+  }
+  for(auto& cell : cells.scaledStdCells) {
+    addDensityArea<DensityCellClass::ScaledStd>(
+        cell->dLx(), cell->dLy(), cell->dUx(), cell->dUy(),
+        cell->densityScale());
+  }
 
-    // The following function is critical runtime hotspot 
-    // for global placer.
-    //
-    if( cell->isInstance() ) {
-      // macro should have 
-      // scale-down with target-density
-      if( cell->isMacroInstance() ) {
-        for(int i = pairX.first; i < pairX.second; i++) {
-          for(int j = pairY.first; j < pairY.second; j++) {
-            Bin* bin = bins_[ j * binCntX_ + i ];
-            bin->addInstPlacedArea( 
-                getOverlapDensityArea(bin, cell) 
-                * cell->densityScale() * bin->targetDensity() ); 
-          }
-        }
-      }
-      // normal cells
-      else if( cell->isStdInstance() ) {
-        for(int i = pairX.first; i < pairX.second; i++) {
-          for(int j = pairY.first; j < pairY.second; j++) {
-            Bin* bin = bins_[ j * binCntX_ + i ];
-            bin->addInstPlacedArea( 
-                getOverlapDensityArea(bin, cell) 
-                * cell->densityScale() ); 
-          }
-        }
-      }
-    }
-    else if( cell->isFiller() ) {
-      for(int i = pairX.first; i < pairX.second; i++) {
-        for(int j = pairY.first; j < pairY.second; j++) {
-          Bin* bin = bins_[ j * binCntX_ + i ];
-          bin->addFillerArea( 
-              getOverlapDensityArea(bin, cell) 
-              * cell->densityScale() ); 
-        }
-      }
-    }
-  }  
+  const int fillerDDx = fillers.dDx;
+  const int fillerDDy = fillers.dDy;
+  const float fillerScale = fillers.densityScale;
+  for(auto& lowerLeft : fillers.lowerLefts) {
+    addDensityArea<DensityCellClass::Filler>(
+        lowerLeft.x, lowerLeft.y, 
+        lowerLeft.x + fillerDDx, lowerLeft.y + fillerDDy,
+        fillerScale);
+  }
 
   overflowArea_ = 0;
 
@@ -821,21 +863,31 @@ BinGrid::updateBinsGCellDensityArea(
 
 std::pair<int, int>
 BinGrid::getDensityMinMaxIdxX(GCell* gcell) {
-  int lowerIdx = (gcell->dLx() - lx())/binSizeX_;
+  return getDensityMinMaxIdxX(gcell->dLx(), gcell->dUx());
+}
+
+std::pair<int, int>
+BinGrid::getDensityMinMaxIdxY(GCell* gcell) {
+  return getDensityMinMaxIdxY(gcell->dLy(), gcell->dUy());
+}
+
+std::pair<int, int>
+BinGrid::getDensityMinMaxIdxX(int dLx, int dUx) {
+  int lowerIdx = (dLx - lx())/binSizeX_;
   int upperIdx = 
-   ( fastModulo((gcell->dUx() - lx()), binSizeX_) == 0)? 
-   (gcell->dUx() - lx()) / binSizeX_ 
-   : (gcell->dUx() - lx()) / binSizeX_ + 1;
+   ( fastModulo((dUx - lx()), binSizeX_) == 0)? 
+   (dUx - lx()) / binSizeX_ 
+   : (dUx - lx()) / binSizeX_ + 1;
   return std::make_pair(lowerIdx, upperIdx);
 }
 
 std::pair<int, int>
-BinGrid::getDensityMinMaxIdxY(GCell* gcell) {
-  int lowerIdx = (gcell->dLy() - ly())/binSizeY_;
+BinGrid::getDensityMinMaxIdxY(int dLy, int dUy) {
+  int lowerIdx = (dLy - ly())/binSizeY_;
   int upperIdx =
-   ( fastModulo((gcell->dUy() - ly()), binSizeY_) == 0)? 
-   (gcell->dUy() - ly()) / binSizeY_ 
-   : (gcell->dUy() - ly()) / binSizeY_ + 1;
+   ( fastModulo((dUy - ly()), binSizeY_) == 0)? 
+   (dUy - ly()) / binSizeY_ 
+   : (dUy - ly()) / binSizeY_ + 1;
 
   return std::make_pair(lowerIdx, upperIdx);
 }
@@ -877,6 +929,7 @@ NesterovBaseVars::NesterovBaseVars()
   minAvgCut(0.1), maxAvgCut(0.9),
   binCntX(0), binCntY(0),
   minWireLengthForceBar(-300),
+  coarseFillerLevel(0),
   isSetBinCntX(0), isSetBinCntY(0) {}
 
 
@@ -889,6 +942,7 @@ NesterovBaseVars::reset() {
   isSetBinCntX = isSetBinCntY = 0;
   binCntX = binCntY = 0;
   minWireLengthForceBar = -300;
+  coarseFillerLevel = 0;
 }
 
 
@@ -896,7 +950,9 @@ NesterovBaseVars::reset() {
 // NesterovBase 
 
 NesterovBase::NesterovBase()
-  : pb_(nullptr), log_(nullptr), sumPhi_(0) {}
+  : pb_(nullptr), log_(nullptr), coarseFillerLevel_(0), 
+  fineFillerCnt_(0), sumPhi_(0),
+  isGPinDensityLocationStale_(false) {}
 
 NesterovBase::NesterovBase(
     NesterovBaseVars nbVars, 
@@ -913,21 +969,45 @@ NesterovBase::~NesterovBase() {
   pb_ = nullptr;
 }
 
+int64_t
+NesterovBase::memoryBytes() const {
+  int64_t bytes = getCapacityBytes(gCellStor_)
+    + getCapacityBytes(gNetStor_)
+    + getCapacityBytes(gPinStor_)
+    + getCapacityBytes(gCells_)
+    + getCapacityBytes(gCellInsts_)
+    + getCapacityBytes(gCellFillers_)
+    + getCapacityBytes(gNets_)
+    + getCapacityBytes(gPins_)
+    + getCapacityBytes(gCellIdMap_)
+    + getCapacityBytes(gPinIdMap_)
+    + getCapacityBytes(gNetIdMap_)
+    + getCapacityBytes(densityCoordiLowerBounds_)
+    + getCapacityBytes(densityCoordiUpperBounds_)
+    + getCapacityBytes(fillerDensity_.lowerLefts)
+    + getCapacityBytes(instDensityCells_.macros)
+    + getCapacityBytes(instDensityCells_.stdCells)
+    + getCapacityBytes(instDensityCells_.scaledStdCells)
+    + getCapacityBytes(gCellGPinStor_)
+    + getCapacityBytes(gNetGPinStor_);
+  return bytes;
+}
+
+int64_t
+NesterovBase::fftMemoryBytes() const {
+  return (fft_)? fft_->memoryBytes() : 0;
+}
+
 void
 NesterovBase::init() {
+  ProfileScope scope(log_, "NesterovBaseInit");
+
   // gCellStor init
-  gCellStor_.reserve(pb_->placeInsts().size());
-  for(auto& inst: pb_->placeInsts()) {
-    GCell myGCell(inst); 
-    // Check whether the given instance is
-    // macro or not
-    if( inst->dy() > pb_->siteSizeY() * 6 ) {
-      myGCell.setMacroInstance();
-    }
-    else {
-      myGCell.setStdInstance();
-    } 
-    gCellStor_.push_back(myGCell);
+  // G-objects refer to the slots of PlacerBase's lists
+  const std::vector<Instance*>& placeInsts = pb_->placeInsts();
+  gCellStor_.reserve(placeInsts.size());
+  for(size_t i=0; i<placeInsts.size(); i++) {
+    gCellStor_.push_back( getInstGCell(&placeInsts[i], pb_->siteSizeY()) );
   }
 
   // TODO: 
@@ -935,55 +1015,114 @@ NesterovBase::init() {
   // Net and Pin
 
   // gPinStor init
-  gPinStor_.reserve(pb_->pins().size());
-  for(auto& pin : pb_->pins()) {
-    GPin myGPin(pin);
+  const std::vector<Pin*>& pins = pb_->pins();
+  gPinStor_.reserve(pins.size());
+  for(size_t i=0; i<pins.size(); i++) {
+    GPin myGPin( PointerRange<Pin>(&pins[i], 1) );
     gPinStor_.push_back(myGPin);
   }
 
   // gNetStor init
-  gNetStor_.reserve(pb_->nets().size());
-  for(auto& net : pb_->nets()) {
-    GNet myGNet(net);
+  const std::vector<Net*>& nets = pb_->nets();
+  gNetStor_.reserve(nets.size());
+  for(size_t i=0; i<nets.size(); i++) {
+    GNet myGNet( PointerRange<Net>(&nets[i], 1) );
     gNetStor_.push_back(myGNet);
   }
 
+  initGObjects();
+}
+
+void
+NesterovBase::sync(NesterovBaseVars nbVars, 
+    std::shared_ptr<Logger> log) {
+  nbVars_ = nbVars;
+  log_ = log;
+  ProfileScope scope(log_, "NesterovBaseSync");
+
+  // fillers are the tail of gCellStor_, and are rebuilt.
+  gCellStor_.resize(gCellInsts_.size());
+
+  const std::vector<Instance*>& placeInsts = pb_->placeInsts();
+  const std::vector<Pin*>& pins = pb_->pins();
+  const std::vector<Net*>& nets = pb_->nets();
+
+  std::vector<int> gCellSlots = compactGObjects(placeInsts, 
+      gCellIdMap_, gCellStor_, 
+      [this](const Instance* inst) { return pb_->instIndex(inst); });
+  std::vector<int> gPinSlots = compactGObjects(pins, 
+      gPinIdMap_, gPinStor_, 
+      [this](const Pin* pin) { return pb_->pinIndex(pin); });
+  std::vector<int> gNetSlots = compactGObjects(nets, 
+      gNetIdMap_, gNetStor_, 
+      [this](const Net* net) { return pb_->netIndex(net); });
+
+  // relink to the rebuilt lists and 
+  // refresh sizes and locations from PlacerBase
+  for(size_t i=0; i<gCellStor_.size(); i++) {
+    gCellStor_[i] = getInstGCell(&placeInsts[gCellSlots[i]], 
+        pb_->siteSizeY());
+  }
+  for(size_t i=0; i<gPinStor_.size(); i++) {
+    gPinStor_[i] = GPin( PointerRange<Pin>(&pins[gPinSlots[i]], 1) );
+  }
+  for(size_t i=0; i<gNetStor_.size(); i++) {
+    gNetStor_[i] = GNet( PointerRange<Net>(&nets[gNetSlots[i]], 1) );
+  }
+
+  sumPhi_ = 0;
+  isGPinDensityLocationStale_ = false;
+  initGObjects();
+}
+
+// fillers, lists, maps, gPin lists, bins and density data
+// from the instance gCells, gPinStor_ and gNetStor_.
+void
+NesterovBase::initGObjects() {
   // update gFillerCells
   initFillerGCells();
 
   // gCell ptr init
+  // fillers are appended after instances by initFillerGCells,
+  // so gCellFillers_ is the tail of gCells_.
+  gCells_.clear();
+  gCellInsts_.clear();
+  gCellFillers_.clear();
   gCells_.reserve(gCellStor_.size());
+  gCellInsts_.reserve(pb_->placeInsts().size());
+  gCellFillers_.reserve(gCellStor_.size() - pb_->placeInsts().size());
+  gCellIdMap_.assign(pb_->instIndexCnt(), nullptr);
   for(auto& gCell : gCellStor_) {
     gCells_.push_back(&gCell);
     if( gCell.isInstance() ) {
-      gCellMap_[gCell.instance()] = &gCell;
+      gCellInsts_.push_back(&gCell);
+      gCellIdMap_[pb_->instIndex(gCell.instance())] = &gCell;
+    }
+    else {
+      gCellFillers_.push_back(&gCell);
     }
   }
   
   // gPin ptr init
+  gPins_.clear();
   gPins_.reserve(gPinStor_.size());
+  gPinIdMap_.assign(pb_->pinIndexCnt(), nullptr);
   for(auto& gPin : gPinStor_) {
     gPins_.push_back(&gPin);
-    gPinMap_[gPin.pin()] = &gPin;
+    gPinIdMap_[pb_->pinIndex(gPin.pin())] = &gPin;
   }
 
   // gNet ptr init
+  gNets_.clear();
   gNets_.reserve(gNetStor_.size());
+  gNetIdMap_.assign(pb_->netIndexCnt(), nullptr);
   for(auto& gNet : gNetStor_) {
     gNets_.push_back(&gNet);
-    gNetMap_[gNet.net()] = &gNet;
+    gNetIdMap_[pb_->netIndex(gNet.net())] = &gNet;
   }
 
-  // gCellStor_'s pins_ fill
-  for(auto& gCell : gCellStor_) {
-    if( gCell.isFiller()) {
-      continue;
-    }
-
-    for( auto& pin : gCell.instance()->pins() ) {
-      gCell.addGPin( placerToNesterov(pin) );
-    }
-  }
+  // gCellStor_'s/gNetStor_'s gPins fill
+  initGPinLists();
 
   // gPinStor_' GNet and GCell fill
   for(auto& gPin : gPinStor_) {
@@ -993,19 +1132,27 @@ NesterovBase::init() {
         placerToNesterov(gPin.pin()->net()));
   } 
 
-  // gNetStor_'s GPin fill
-  for(auto& gNet : gNetStor_) {
-    for(auto& pin : gNet.net()->pins()) {
-      gNet.addGPin( placerToNesterov(pin) );
-    }
-  }
-
   log_->infoInt("FillerInit: NumGCells", gCells_.size());
   log_->infoInt("FillerInit: NumGNets", gNets_.size());
   log_->infoInt("FillerInit: NumGPins", gPins_.size());
 
+  initBinGrid();
+
+  // update densitySize and densityScale in each gCell
+  for(auto& gCell : gCells_) {
+    updateDensitySize(gCell);
+  } 
+
+  initDensityCoordiBounds();
+  initFillerDensity();
+  initInstDensityCells();
+}
+
+void
+NesterovBase::initBinGrid() {
   // initialize bin grid structure
   // send param into binGrid structure
+  bg_.unsetBinCnt();
   if( nbVars_.isSetBinCntX ) {
     bg_.setBinCntX(nbVars_.binCntX);
   }
@@ -1014,6 +1161,11 @@ NesterovBase::init() {
     bg_.setBinCntY(nbVars_.binCntY);
   }
 
+  const int prevBinCntX = bg_.binCntX();
+  const int prevBinCntY = bg_.binCntY();
+  const int prevBinSizeX = bg_.binSizeX();
+  const int prevBinSizeY = bg_.binSizeY();
+
   bg_.setPlacerBase(pb_);
   bg_.setLogger(log_);
   bg_.setCoordi(&(pb_->die()));
@@ -1022,46 +1174,151 @@ NesterovBase::init() {
   // update binGrid info
   bg_.initBins();
 
-
-  // initialize fft structrue based on bins
+  // initialize fft structrue based on bins.
+  // A synced NesterovBase keeps it on the same bins.
+  if( fft_ && bg_.binCntX() == prevBinCntX && bg_.binCntY() == prevBinCntY
+      && bg_.binSizeX() == prevBinSizeX && bg_.binSizeY() == prevBinSizeY ) {
+    return;
+  }
   std::unique_ptr<FFT> fft(new FFT(bg_.binCntX(), bg_.binCntY(), 
         bg_.binSizeX(), bg_.binSizeY()));
 
   fft_ = std::move(fft);
+}
 
+// small cells are inflated to sqrt(2) bins with a scaled-down density
+void
+NesterovBase::updateDensitySize(GCell* gCell) {
+  float scaleX = 0, scaleY = 0;
+  float densitySizeX = 0, densitySizeY = 0;
+  if( gCell->dx() < REPLACE_SQRT2 * bg_.binSizeX() ) {
+    scaleX = static_cast<float>(gCell->dx()) 
+      / static_cast<float>( REPLACE_SQRT2 * bg_.binSizeX());
+    densitySizeX = REPLACE_SQRT2 
+      * static_cast<float>(bg_.binSizeX());
+  }
+  else {
+    scaleX = 1.0;
+    densitySizeX = gCell->dx();
+  }
 
-  // update densitySize and densityScale in each gCell
-  for(auto& gCell : gCells_) {
-    float scaleX = 0, scaleY = 0;
-    float densitySizeX = 0, densitySizeY = 0;
-    if( gCell->dx() < REPLACE_SQRT2 * bg_.binSizeX() ) {
-      scaleX = static_cast<float>(gCell->dx()) 
-        / static_cast<float>( REPLACE_SQRT2 * bg_.binSizeX());
-      densitySizeX = REPLACE_SQRT2 
-        * static_cast<float>(bg_.binSizeX());
+  if( gCell->dy() < REPLACE_SQRT2 * bg_.binSizeY() ) {
+    scaleY = static_cast<float>(gCell->dy()) 
+      / static_cast<float>( REPLACE_SQRT2 * bg_.binSizeY());
+    densitySizeY = REPLACE_SQRT2 
+      * static_cast<float>(bg_.binSizeY());
+  }
+  else {
+    scaleY = 1.0;
+    densitySizeY = gCell->dy();
+  }
+
+  gCell->setDensitySize(densitySizeX, densitySizeY);
+  gCell->setDensityScale(scaleX * scaleY);
+}
+
+// precompute the clamping range used in 
+// getDensityCoordiLayoutInsideX/Y for each gCell.
+void
+NesterovBase::initDensityCoordiBounds() {
+  densityCoordiLowerBounds_.resize(gCells_.size());
+  densityCoordiUpperBounds_.resize(gCells_.size());
+
+  for(size_t i=0; i<gCells_.size(); i++) {
+    GCell* gCell = gCells_[i];
+    densityCoordiLowerBounds_[i] = FloatPoint(
+        bg_.lx() + gCell->dDx()/2,
+        bg_.ly() + gCell->dDy()/2);
+    densityCoordiUpperBounds_[i] = FloatPoint(
+        bg_.ux() - gCell->dDx()/2,
+        bg_.uy() - gCell->dDy()/2);
+  }
+}
+
+// fillers are created with the same size in initFillerGCells,
+// so the first filler's density size and scale are shared.
+void
+NesterovBase::initFillerDensity() {
+  fillerDensity_.lowerLefts.resize(gCellFillers_.size());
+  if( !gCellFillers_.empty() ) {
+    fillerDensity_.dDx = gCellFillers_[0]->dDx();
+    fillerDensity_.dDy = gCellFillers_[0]->dDy();
+    fillerDensity_.densityScale = gCellFillers_[0]->densityScale();
+  }
+  updateFillerDensityLocations();
+}
+
+// instance classes don't change after init;
+// only the order of gCellInsts_ does (See reorderForLocality).
+void
+NesterovBase::initInstDensityCells() {
+  instDensityCells_.clear();
+  for(auto& gCell : gCellInsts_) {
+    if( gCell->isMacroInstance() ) {
+      instDensityCells_.macros.push_back(gCell);
     }
-    else {
-      scaleX = 1.0;
-      densitySizeX = gCell->dx();
+    else if( gCell->isStdInstance() ) {
+      if( gCell->densityScale() == 1.0f ) {
+        instDensityCells_.stdCells.push_back(gCell);
+      }
+      else {
+        instDensityCells_.scaledStdCells.push_back(gCell);
+      }
     }
+  }
+}
+
+void
+NesterovBase::updateFillerDensityLocations() {
+  for(size_t i=0; i<gCellFillers_.size(); i++) {
+    fillerDensity_.lowerLefts[i] = IntPoint(
+        gCellFillers_[i]->dLx(), gCellFillers_[i]->dLy());
+  }
+}
 
-    if( gCell->dy() < REPLACE_SQRT2 * bg_.binSizeY() ) {
-      scaleY = static_cast<float>(gCell->dy()) 
-        / static_cast<float>( REPLACE_SQRT2 * bg_.binSizeY());
-      densitySizeY = REPLACE_SQRT2 
-        * static_cast<float>(bg_.binSizeY());
+// Count-then-fill of gCells' and gNets' gPin lists,
+// in their Instance's/Net's pin order.
+// Fillers have no gPins.
+void
+NesterovBase::initGPinLists() {
+  size_t gCellGPinCnt = 0;
+  for(auto& gCell : gCellStor_) {
+    if( gCell.isInstance() ) {
+      gCellGPinCnt += gCell.instance()->pins().size();
     }
-    else {
-      scaleY = 1.0;
-      densitySizeY = gCell->dy();
+  }
+  size_t gNetGPinCnt = 0;
+  for(auto& gNet : gNetStor_) {
+    gNetGPinCnt += gNet.net()->pins().size();
+  }
+
+  // reserved, so the ranges stay valid while filling
+  gCellGPinStor_.clear();
+  gCellGPinStor_.reserve(gCellGPinCnt);
+  for(auto& gCell : gCellStor_) {
+    if( !gCell.isInstance() ) {
+      continue;
     }
+    const size_t begin = gCellGPinStor_.size();
+    for(auto& pin : gCell.instance()->pins()) {
+      gCellGPinStor_.push_back( placerToNesterov(pin) );
+    }
+    gCell.setGPins( PointerRange<GPin>(
+          gCellGPinStor_.data() + begin, gCellGPinStor_.size() - begin) );
+  }
 
-    gCell->setDensitySize(densitySizeX, densitySizeY);
-    gCell->setDensityScale(scaleX * scaleY);
-  } 
+  gNetGPinStor_.clear();
+  gNetGPinStor_.reserve(gNetGPinCnt);
+  for(auto& gNet : gNetStor_) {
+    const size_t begin = gNetGPinStor_.size();
+    for(auto& pin : gNet.net()->pins()) {
+      gNetGPinStor_.push_back( placerToNesterov(pin) );
+    }
+    gNet.setGPins( PointerRange<GPin>(
+          gNetGPinStor_.data() + begin, gNetGPinStor_.size() - begin) );
+  }
 }
 
-
 // virtual filler GCells
 void
 NesterovBase::initFillerGCells() {
@@ -1124,6 +1381,30 @@ NesterovBase::initFillerGCells() {
     static_cast<int>(totalFillerArea 
         / static_cast<int64_t>(avgDx * avgDy));
 
+  // coarse fillers cover 2^level x 2^level fillers.
+  // Even sizes are halved exactly down to the finest level, 
+  // which has the same size as the GCell(cx, cy, dx, dy) rounding.
+  // The coarse filler count is rounded up, so coarse fillers 
+  // cover at least the fillers' area, and the last split 
+  // drops the extra fine fillers.
+  fineFillerCnt_ = fillerCnt;
+  int fillerDx = avgDx;
+  int fillerDy = avgDy;
+  int fillerSplitCnt = 1;
+  coarseFillerLevel_ = nbVars_.coarseFillerLevel;
+  while( coarseFillerLevel_ > 0 
+      && ( (fillerCnt >> (2 * coarseFillerLevel_)) == 0
+        || ((avgDx/2*2) << coarseFillerLevel_) > pb_->die().coreDx()
+        || ((avgDy/2*2) << coarseFillerLevel_) > pb_->die().coreDy() ) ) {
+    coarseFillerLevel_--;
+  }
+  if( coarseFillerLevel_ > 0 ) {
+    fillerDx = (avgDx/2*2) << coarseFillerLevel_;
+    fillerDy = (avgDy/2*2) << coarseFillerLevel_;
+    fillerSplitCnt = 1 << (2 * coarseFillerLevel_);
+    fillerCnt = (fillerCnt + fillerSplitCnt - 1) / fillerSplitCnt;
+  }
+
   log_->infoInt64("FillerInit: CoreArea", coreArea, 3);
   log_->infoInt64("FillerInit: WhiteSpaceArea", whiteSpaceArea, 3);
   log_->infoInt64("FillerInit: MovableArea", movableArea, 3);
@@ -1131,6 +1412,19 @@ NesterovBase::initFillerGCells() {
   log_->infoInt("FillerInit: NumFillerCells", fillerCnt, 3);
   log_->infoInt64("FillerInit: FillerCellArea", static_cast<int64_t>(avgDx*avgDy), 3);
   log_->infoIntPair("FillerInit: FillerCellSize", avgDx, avgDy, 3); 
+  if( coarseFillerLevel_ > 0 ) {
+    log_->infoInt("FillerInit: CoarseFillerLevel", coarseFillerLevel_);
+    log_->infoInt("FillerInit: NumCoarseFillerCells", fillerCnt);
+    log_->infoIntPair("FillerInit: CoarseFillerCellSize", fillerDx, fillerDy);
+    log_->infoInt64("FillerInit: ExtraCoarseFillerArea", 
+        (static_cast<int64_t>(fillerCnt) * fillerSplitCnt - fineFillerCnt_)
+        * avgDx * avgDy, 3);
+  }
+
+  // splitFillerGCells must not reallocate gCellStor_,
+  // as gCells_ and gPins refer to it.
+  gCellStor_.reserve(gCellStor_.size() 
+      + static_cast<size_t>(fillerCnt) * fillerSplitCnt);
 
   // 
   // mt19937 supports huge range of random values.
@@ -1148,37 +1442,92 @@ NesterovBase::initFillerGCells() {
     GCell myGCell(
         randX % pb_->die().coreDx() + pb_->die().coreLx(), 
         randY % pb_->die().coreDy() + pb_->die().coreLy(),
-        avgDx, avgDy );
+        fillerDx, fillerDy );
 
     gCellStor_.push_back(myGCell);
   }
 }
 
+bool
+NesterovBase::splitFillerGCells() {
+  if( coarseFillerLevel_ == 0 ) {
+    return false;
+  }
+  coarseFillerLevel_--;
+
+  const int fillerCnt = gCellFillers_.size();
+  if( fillerCnt == 0 ) {
+    return true;
+  }
+
+  const int childDx = gCellFillers_[0]->dx() / 2;
+  const int childDy = gCellFillers_[0]->dy() / 2;
+
+  // the last split keeps fineFillerCnt_ fillers;
+  // the extra children at the tail are not created.
+  const size_t splitFillerCnt = (coarseFillerLevel_ == 0)?
+    fineFillerCnt_ : static_cast<size_t>(fillerCnt) * 4;
+
+  // child 0 replaces its parent in place
+  for(int i=0; i<fillerCnt; i++) {
+    GCell* parent = gCellFillers_[i];
+    const int cx = parent->dCx();
+    const int cy = parent->dCy();
+
+    for(int child=1; child<4 
+        && gCellFillers_.size() < splitFillerCnt; child++) {
+      const int offsetX = (child & 1)? childDx/2 : -childDx/2;
+      const int offsetY = (child & 2)? childDy/2 : -childDy/2;
+      gCellStor_.push_back(
+          GCell(cx + offsetX, cy + offsetY, childDx, childDy));
+      GCell* gCell = &gCellStor_.back();
+      gCells_.push_back(gCell);
+      gCellFillers_.push_back(gCell);
+    }
+    *parent = GCell(cx - childDx/2, cy - childDy/2, childDx, childDy);
+  }
+
+  for(auto& gCell : gCellFillers_) {
+    updateDensitySize(gCell);
+  }
+
+  initDensityCoordiBounds();
+  initFillerDensity();
+
+  log_->infoInt("FillerSplit: CoarseFillerLevel", coarseFillerLevel_, 3);
+  return true;
+}
+
+FloatPoint
+NesterovBase::getFillerSplitOffset(int child) const {
+  if( gCellFillers_.empty() ) {
+    return FloatPoint();
+  }
+  const float halfDx = static_cast<float>(gCellFillers_[0]->dx() / 2);
+  const float halfDy = static_cast<float>(gCellFillers_[0]->dy() / 2);
+  return FloatPoint( (child & 1)? halfDx : -halfDx,
+      (child & 2)? halfDy : -halfDy );
+}
+
 GCell*
 NesterovBase::placerToNesterov(Instance* inst) {
-  auto gcPtr = gCellMap_.find(inst);
-  return (gcPtr == gCellMap_.end())?
-    nullptr : gcPtr->second;
+  return (inst)? gCellIdMap_[pb_->instIndex(inst)] : nullptr;
 }
 
 GNet*
 NesterovBase::placerToNesterov(Net* net) {
-  auto gnPtr = gNetMap_.find(net);
-  return (gnPtr == gNetMap_.end())?
-    nullptr : gnPtr->second;
+  return (net)? gNetIdMap_[pb_->netIndex(net)] : nullptr;
 }
 
 GPin*
 NesterovBase::placerToNesterov(Pin* pin) {
-  auto gpPtr = gPinMap_.find(pin);
-  return (gpPtr == gPinMap_.end())?
-    nullptr : gpPtr->second;
+  return (pin)? gPinIdMap_[pb_->pinIndex(pin)] : nullptr;
 }
 
 // gcell update
 void
 NesterovBase::updateGCellLocation(
-    std::vector<FloatPoint>& coordis) {
+    FloatPointArray& coordis) {
   for(auto& coordi : coordis) {
     int idx = &coordi - &coordis[0];
     gCells_[idx]->setLocation( coordi.x, coordi.y );
@@ -1188,7 +1537,7 @@ NesterovBase::updateGCellLocation(
 // gcell update
 void
 NesterovBase::updateGCellCenterLocation(
-    std::vector<FloatPoint>& coordis) {
+    FloatPointArray& coordis) {
   for(auto& coordi : coordis) {
     int idx = &coordi - &coordis[0];
     gCells_[idx]->setCenterLocation( coordi.x, coordi.y );
@@ -1197,13 +1546,87 @@ NesterovBase::updateGCellCenterLocation(
 
 void
 NesterovBase::updateGCellDensityCenterLocation(
-    std::vector<FloatPoint>& coordis) {
+    FloatPointArray& coordis) {
   for(auto& coordi : coordis) {
     int idx = &coordi - &coordis[0];
     gCells_[idx]->setDensityCenterLocation( 
         coordi.x, coordi.y );
   }
-  bg_.updateBinsGCellDensityArea( gCells_ );
+  updateFillerDensityLocations();
+  isGPinDensityLocationStale_ = false;
+  bg_.updateBinsGCellDensityArea( instDensityCells_, fillerDensity_ );
+}
+
+void
+NesterovBase::updateNextCoordi(
+    const FloatPointArray& curSLPCoordi,
+    const FloatPointArray& curSLPSumGrads,
+    const FloatPointArray& curCoordi,
+    float stepLength, float coeff,
+    FloatPointArray& nextCoordi,
+    FloatPointArray& nextSLPCoordi) {
+
+  const int gCellSize = gCells_.size();
+  const int fillerBegin = gCellInsts_.size();
+  IntPoint* fillerLowerLefts = fillerDensity_.lowerLefts.data();
+  const FloatPoint* lower = densityCoordiLowerBounds_.data();
+  const FloatPoint* upper = densityCoordiUpperBounds_.data();
+
+  // Note that the clamping must be the same as 
+  // getDensityCoordiLayoutInsideX/Y,
+  // i.e. the upper bound wins when a gCell is larger than layout.
+#pragma omp parallel for schedule(static)
+  for(int k=0; k<gCellSize; k++) {
+    const float nextX 
+      = curSLPCoordi[k].x + stepLength * curSLPSumGrads[k].x;
+    const float nextY 
+      = curSLPCoordi[k].y + stepLength * curSLPSumGrads[k].y;
+
+    const float nextSLPX = nextX + coeff * (nextX - curCoordi[k].x);
+    const float nextSLPY = nextY + coeff * (nextY - curCoordi[k].y);
+
+    nextCoordi[k].x = (nextX > upper[k].x)? upper[k].x :
+      ((nextX < lower[k].x)? lower[k].x : nextX);
+    nextCoordi[k].y = (nextY > upper[k].y)? upper[k].y :
+      ((nextY < lower[k].y)? lower[k].y : nextY);
+
+    nextSLPCoordi[k].x = (nextSLPX > upper[k].x)? upper[k].x :
+      ((nextSLPX < lower[k].x)? lower[k].x : nextSLPX);
+    nextSLPCoordi[k].y = (nextSLPY > upper[k].y)? upper[k].y :
+      ((nextSLPY < lower[k].y)? lower[k].y : nextSLPY);
+
+    GCell* gCell = gCells_[k];
+    gCell->moveDensityCenterLocation(
+        static_cast<int>(nextSLPCoordi[k].x), 
+        static_cast<int>(nextSLPCoordi[k].y));
+
+    if( k >= fillerBegin ) {
+      fillerLowerLefts[k - fillerBegin].x = gCell->dLx();
+      fillerLowerLefts[k - fillerBegin].y = gCell->dLy();
+    }
+  }
+
+  isGPinDensityLocationStale_ = true;
+  bg_.updateBinsGCellDensityArea( instDensityCells_, fillerDensity_ );
+}
+
+// gPins on placeable gCells follow their gCells' density coordinates.
+// gPins from fixed instances or IO ports have no gCell.
+void
+NesterovBase::updateGPinsDensityLocation() {
+  if( !isGPinDensityLocationStale_ ) {
+    return;
+  }
+
+  const int gPinSize = gPins_.size();
+#pragma omp parallel for schedule(static)
+  for(int i=0; i<gPinSize; i++) {
+    GPin* gPin = gPins_[i];
+    if( gPin->gCell() ) {
+      gPin->updateDensityLocation( gPin->gCell() );
+    }
+  }
+  isGPinDensityLocationStale_ = false;
 }
 
 int
@@ -1304,6 +1727,10 @@ NesterovBase::getDensityCoordiLayoutInsideY(GCell* gCell, float cy) {
 void
 NesterovBase::updateWireLengthForceWA(
     float wlCoeffX, float wlCoeffY) {
+  ProfileScope scope(log_, "WireLengthWA");
+
+  // deferred from updateNextCoordi
+  updateGPinsDensityLocation();
 
   // clear all WA variables.
   for(auto& gNet : gNets_) {
@@ -1477,6 +1904,42 @@ NesterovBase::getDensityGradient(GCell* gCell) {
   return electroForce;
 }
 
+// fillers have no pins, so only the density gradient is needed;
+// the clamped overlap is the same as getOverlapDensityArea.
+FloatPoint
+NesterovBase::getFillerDensityGradient(int fillerIdx) {
+  const int dLx = fillerDensity_.lowerLefts[fillerIdx].x;
+  const int dLy = fillerDensity_.lowerLefts[fillerIdx].y;
+  const int dUx = dLx + fillerDensity_.dDx;
+  const int dUy = dLy + fillerDensity_.dDy;
+  const float scale = fillerDensity_.densityScale;
+
+  std::pair<int, int> pairX 
+    = bg_.getDensityMinMaxIdxX(dLx, dUx);
+  std::pair<int, int> pairY 
+    = bg_.getDensityMinMaxIdxY(dLy, dUy);
+
+  const std::vector<Bin*>& bins = bg_.bins();
+  const int binCntX = bg_.binCntX();
+  
+  FloatPoint electroForce;
+
+  for(int i = pairX.first; i < pairX.second; i++) {
+    for(int j = pairY.first; j < pairY.second; j++) {
+      Bin* bin = bins[ j * binCntX + i ];
+      const float overlapX = static_cast<float>( 
+          max(0, min(bin->ux(), dUx) - max(bin->lx(), dLx)) );
+      const float overlapY = static_cast<float>( 
+          max(0, min(bin->uy(), dUy) - max(bin->ly(), dLy)) );
+      float overlapArea = overlapX * overlapY * scale;
+
+      electroForce.x += overlapArea * bin->electroForceX();
+      electroForce.y += overlapArea * bin->electroForceY();
+    }
+  }
+  return electroForce;
+}
+
 // Density force cals
 void
 NesterovBase::updateDensityForceBin() {
@@ -1487,7 +1950,10 @@ NesterovBase::updateDensityForceBin() {
   }
 
   // do FFT
-  fft_->doFFT();
+  {
+    ProfileScope scope(log_, "DensityFFT");
+    fft_->doFFT();
+  }
 
   // update electroPhi and electroForce
   // update sumPhi_ for nesterov loop
@@ -1507,6 +1973,8 @@ NesterovBase::updateDensityForceBin() {
 
 int64_t
 NesterovBase::getHpwl() {
+  updateGPinsDensityLocation();
+
   int64_t hpwl = 0;
   for(auto& gNet : gNets_) {
     gNet->updateBox();
@@ -1515,6 +1983,178 @@ NesterovBase::getHpwl() {
   return hpwl;
 }
 
+void
+NesterovBase::reorderForLocality(std::vector<int>& newToOld) {
+  ProfileScope scope(log_, "LocalityOrder");
+
+  const int gCellSize = gCells_.size();
+  const int fillerBegin = gCellInsts_.size();
+
+  // gCells' density centers on the 2^16 x 2^16 Hilbert grid of the die
+  const float scaleX = 65535.0f / std::max(1, bg_.dx());
+  const float scaleY = 65535.0f / std::max(1, bg_.dy());
+  std::vector<uint64_t> keys(gCellSize);
+  for(int i=0; i<gCellSize; i++) {
+    const int x = std::min(std::max(gCells_[i]->dCx() - bg_.lx(), 0), bg_.dx());
+    const int y = std::min(std::max(gCells_[i]->dCy() - bg_.ly(), 0), bg_.dy());
+    keys[i] = getHilbertKey(
+        static_cast<uint32_t>(x * scaleX),
+        static_cast<uint32_t>(y * scaleY));
+  }
+
+  newToOld.resize(gCellSize);
+  for(int i=0; i<gCellSize; i++) {
+    newToOld[i] = i;
+  }
+  auto keyLess = [&keys](int a, int b) { return keys[a] < keys[b]; };
+  std::stable_sort(newToOld.begin(), newToOld.begin() + fillerBegin, keyLess);
+  std::stable_sort(newToOld.begin() + fillerBegin, newToOld.end(), keyLess);
+
+  // gPins follow their gCells; gPins without gCells 
+  // (fixed instances or IO ports) keep their order at the end.
+  const int gPinSize = gPins_.size();
+  std::vector<int> gPinOldToNew(gPinSize, -1);
+  std::vector<int> gPinNewToOld;
+  gPinNewToOld.reserve(gPinSize);
+  for(int i=0; i<gCellSize; i++) {
+    for(auto& gPin : gCellStor_[newToOld[i]].gPins()) {
+      const int idx = gPin - gPinStor_.data();
+      gPinOldToNew[idx] = gPinNewToOld.size();
+      gPinNewToOld.push_back(idx);
+    }
+  }
+  for(int i=0; i<gPinSize; i++) {
+    if( gPinOldToNew[i] == -1 ) {
+      gPinOldToNew[i] = gPinNewToOld.size();
+      gPinNewToOld.push_back(i);
+    }
+  }
+
+  // gNets are ordered by their first gPin
+  const int gNetSize = gNets_.size();
+  std::vector<int> gNetOldToNew(gNetSize, -1);
+  std::vector<int> gNetNewToOld;
+  gNetNewToOld.reserve(gNetSize);
+  for(auto& pinIdx : gPinNewToOld) {
+    GNet* gNet = gPinStor_[pinIdx].gNet();
+    if( !gNet ) {
+      continue;
+    }
+    const int idx = gNet - gNetStor_.data();
+    if( gNetOldToNew[idx] == -1 ) {
+      gNetOldToNew[idx] = gNetNewToOld.size();
+      gNetNewToOld.push_back(idx);
+    }
+  }
+  for(int i=0; i<gNetSize; i++) {
+    if( gNetOldToNew[i] == -1 ) {
+      gNetOldToNew[i] = gNetNewToOld.size();
+      gNetNewToOld.push_back(i);
+    }
+  }
+
+  std::vector<int> gCellOldToNew(gCellSize);
+  for(int i=0; i<gCellSize; i++) {
+    gCellOldToNew[newToOld[i]] = i;
+  }
+
+  // permute the storages. 
+  // gCellStor_ keeps its capacity for splitFillerGCells.
+  std::vector<GCell> gCellStor;
+  gCellStor.reserve(gCellStor_.capacity());
+  for(auto& idx : newToOld) {
+    gCellStor.push_back(gCellStor_[idx]);
+  }
+  std::vector<GPin> gPinStor;
+  gPinStor.reserve(gPinSize);
+  for(auto& idx : gPinNewToOld) {
+    gPinStor.push_back(gPinStor_[idx]);
+  }
+  std::vector<GNet> gNetStor;
+  gNetStor.reserve(gNetSize);
+  for(auto& idx : gNetNewToOld) {
+    gNetStor.push_back(gNetStor_[idx]);
+  }
+
+  // re-link references; 
+  // old pointers are still valid until the swaps below.
+  // gPin lists are rebuilt in the new gCell/gNet order,
+  // reserved first so the ranges stay valid.
+  std::vector<GPin*> gCellGPinStor;
+  gCellGPinStor.reserve(gCellGPinStor_.size());
+  for(auto& gCell : gCellStor) {
+    const size_t begin = gCellGPinStor.size();
+    for(auto& gPin : gCell.gPins()) {
+      gCellGPinStor.push_back( 
+          &gPinStor[gPinOldToNew[gPin - gPinStor_.data()]] );
+    }
+    gCell.setGPins( PointerRange<GPin>(
+          gCellGPinStor.data() + begin, gCellGPinStor.size() - begin) );
+  }
+  std::vector<GPin*> gNetGPinStor;
+  gNetGPinStor.reserve(gNetGPinStor_.size());
+  for(auto& gNet : gNetStor) {
+    const size_t begin = gNetGPinStor.size();
+    for(auto& gPin : gNet.gPins()) {
+      gNetGPinStor.push_back( 
+          &gPinStor[gPinOldToNew[gPin - gPinStor_.data()]] );
+    }
+    gNet.setGPins( PointerRange<GPin>(
+          gNetGPinStor.data() + begin, gNetGPinStor.size() - begin) );
+  }
+  for(auto& gPin : gPinStor) {
+    if( gPin.gCell() ) {
+      gPin.setGCell( 
+          &gCellStor[gCellOldToNew[gPin.gCell() - gCellStor_.data()]] );
+    }
+    if( gPin.gNet() ) {
+      gPin.setGNet(
+          &gNetStor[gNetOldToNew[gPin.gNet() - gNetStor_.data()]] );
+    }
+  }
+  for(auto& gCell : gCellIdMap_) {
+    if( gCell ) {
+      gCell = &gCellStor[gCellOldToNew[gCell - gCellStor_.data()]];
+    }
+  }
+  for(auto& gPin : gPinIdMap_) {
+    if( gPin ) {
+      gPin = &gPinStor[gPinOldToNew[gPin - gPinStor_.data()]];
+    }
+  }
+  for(auto& gNet : gNetIdMap_) {
+    if( gNet ) {
+      gNet = &gNetStor[gNetOldToNew[gNet - gNetStor_.data()]];
+    }
+  }
+
+  gCellStor_.swap(gCellStor);
+  gPinStor_.swap(gPinStor);
+  gNetStor_.swap(gNetStor);
+  gCellGPinStor_.swap(gCellGPinStor);
+  gNetGPinStor_.swap(gNetGPinStor);
+
+  for(int i=0; i<gCellSize; i++) {
+    gCells_[i] = &gCellStor_[i];
+  }
+  for(int i=0; i<fillerBegin; i++) {
+    gCellInsts_[i] = gCells_[i];
+  }
+  for(int i=fillerBegin; i<gCellSize; i++) {
+    gCellFillers_[i - fillerBegin] = gCells_[i];
+  }
+  for(int i=0; i<gPinSize; i++) {
+    gPins_[i] = &gPinStor_[i];
+  }
+  for(int i=0; i<gNetSize; i++) {
+    gNets_[i] = &gNetStor_[i];
+  }
+
+  initDensityCoordiBounds();
+  updateFillerDensityLocations();
+  initInstDensityCells();
+}
+
 void
 NesterovBase::reset() { 
   pb_ = nullptr;
@@ -1563,6 +2203,30 @@ getOverlapArea(Bin* bin, Instance* inst) {
   }
 }
 
+// (x, y) to the distance along the Hilbert curve 
+// on the 2^16 x 2^16 grid.
+// https://en.wikipedia.org/wiki/Hilbert_curve
+static uint64_t
+getHilbertKey(uint32_t x, uint32_t y) {
+  const uint32_t n = 1u << 16;
+  uint64_t key = 0;
+  for(uint32_t s = n/2; s > 0; s /= 2) {
+    const uint32_t rx = (x & s) > 0;
+    const uint32_t ry = (y & s) > 0;
+    key += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+
+    // rotate the quadrant
+    if( ry == 0 ) {
+      if( rx == 1 ) {
+        x = n-1 - x;
+        y = n-1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return key;
+}
+
 // 
 // https://codingforspeed.com/using-faster-exponential-approximation/
 static float
@@ -1583,4 +2247,54 @@ fastExp(float a) {
 
 
 
+static GCell
+getInstGCell(Instance* const* placeInst, int siteSizeY) {
+  GCell gCell( PointerRange<Instance>(placeInst, 1) ); 
+  // Check whether the given instance is
+  // macro or not
+  if( (*placeInst)->dy() > siteSizeY * 6 ) {
+    gCell.setMacroInstance();
+  }
+  else {
+    gCell.setStdInstance();
+  } 
+  return gCell;
+}
+
+// Compacts gStor to the G-objects whose PlacerBase objects 
+// are still in list, in their order, and appends default 
+// G-objects for list's new objects. 
+// idMap is the previous PlacerBase index to G-object map.
+// Returns the list slots of gStor's G-objects.
+template <class T, class GT, class Index>
+static std::vector<int>
+compactGObjects(const std::vector<T*>& list, 
+    const std::vector<GT*>& idMap, std::vector<GT>& gStor, Index index) {
+  std::vector<int> slots(gStor.size(), -1);
+  std::vector<int> newSlots;
+  for(size_t i=0; i<list.size(); i++) {
+    const size_t idx = index(list[i]);
+    GT* gObj = (idx < idMap.size())? idMap[idx] : nullptr;
+    if( gObj ) {
+      slots[gObj - gStor.data()] = i;
+    }
+    else {
+      newSlots.push_back(i);
+    }
+  }
+
+  size_t gObjCnt = 0;
+  for(size_t i=0; i<gStor.size(); i++) {
+    if( slots[i] == -1 ) {
+      continue;
+    }
+    gStor[gObjCnt] = gStor[i];
+    slots[gObjCnt++] = slots[i];
+  }
+  slots.resize(gObjCnt);
+  slots.insert(slots.end(), newSlots.begin(), newSlots.end());
+  gStor.resize(slots.size());
+  return slots;
+}
+
 }
@@ -3,9 +3,9 @@
 
 #include <vector>
 #include <memory>
-#include <unordered_map>
 
 #include "point.h"
+#include "pointerRange.h"
 
 namespace replace {
 
@@ -26,22 +26,22 @@ class GCell {
 public:
   GCell();
 
-  // instance cells
-  GCell(Instance* inst);
-  GCell(std::vector<Instance*>& insts);
+  // instance cells. 
+  // insts is a range of PlacerBase's instance list.
+  GCell(PointerRange<Instance> insts);
 
   // filler cells
   GCell(int cx, int cy, int dx, int dy);
-  ~GCell();
 
   Instance* instance() const;
-  const std::vector<Instance*> & insts() const { return insts_; }
-  const std::vector<GPin*> & gPins() const { return gPins_; }
+  PointerRange<Instance> insts() const { return insts_; }
 
-  void addGPin(GPin* gPin);
+  // gPins are stored in NesterovBase (See NesterovBase::initGPinLists)
+  PointerRange<GPin> gPins() const { return gPins_; }
+  void setGPins(PointerRange<GPin> gPins);
 
-  void setClusteredInstance(std::vector<Instance*>& insts);
-  void setInstance(Instance* inst);
+  void setClusteredInstance(PointerRange<Instance> insts);
+  void setInstance(PointerRange<Instance> inst);
   void setFiller();
   void setMacroInstance();
   void setStdInstance();
@@ -73,6 +73,9 @@ public:
 
   void setDensityLocation(int dLx, int dLy);
   void setDensityCenterLocation(int dCx, int dCy);
+  // same as setDensityCenterLocation, but gPins are not updated.
+  // See NesterovBase::updateGPinsDensityLocation
+  void moveDensityCenterLocation(int dCx, int dCy);
   void setDensitySize(int dDx, int dDy);
 
   void setDensityScale(float densityScale);
@@ -91,8 +94,8 @@ public:
 
 
 private:
-  std::vector<Instance*> insts_;
-  std::vector<GPin*> gPins_;
+  PointerRange<Instance> insts_;
+  PointerRange<GPin> gPins_;
   int lx_;
   int ly_;
   int ux_;
@@ -191,16 +194,29 @@ GCell::dDy() const {
   return dUy_ - dLy_;
 }
 
+inline void
+GCell::moveDensityCenterLocation(int dCx, int dCy) {
+  const int halfDDx = dDx()/2;
+  const int halfDDy = dDy()/2;
+
+  dLx_ = dCx - halfDDx;
+  dLy_ = dCy - halfDDy;
+  dUx_ = dCx + halfDDx;
+  dUy_ = dCy + halfDDy;
+}
+
 class GNet {
   public:
     GNet();
-    GNet(Net* net);
-    GNet(std::vector<Net*>& nets);
-    ~GNet();
+    // nets is a range of PlacerBase's net list.
+    GNet(PointerRange<Net> nets);
 
     Net* net() const;
-    const std::vector<Net*> & nets() const { return nets_; }
-    const std::vector<GPin*> & gPins() const { return gPins_; }
+    PointerRange<Net> nets() const { return nets_; }
+
+    // gPins are stored in NesterovBase (See NesterovBase::initGPinLists)
+    PointerRange<GPin> gPins() const { return gPins_; }
+    void setGPins(PointerRange<GPin> gPins);
 
     int lx() const;
     int ly() const;
@@ -211,7 +227,6 @@ class GNet {
     float customWeight() const { return customWeight_; }
     float netWeight() const { return weight_; }
 
-    void addGPin(GPin* gPin);
     void updateBox();
     int64_t hpwl();
 
@@ -247,8 +262,8 @@ class GNet {
 
 
   private:
-    std::vector<GPin*> gPins_;
-    std::vector<Net*> nets_;
+    PointerRange<GPin> gPins_;
+    PointerRange<Net> nets_;
     int lx_;
     int ly_;
     int ux_;
@@ -402,12 +417,12 @@ GNet::waYExpMaxSumY() const {
 class GPin {
   public:
     GPin();
-    GPin(Pin* pin);
-    GPin(std::vector<Pin*>& pins);
-    ~GPin();
+    // pins is a range of PlacerBase's pin list.
+    // the location is taken from the first pin.
+    GPin(PointerRange<Pin> pins);
 
     Pin* pin() const;
-    const std::vector<Pin*> & pins() const { return pins_; }
+    PointerRange<Pin> pins() const { return pins_; }
 
     GCell* gCell() const { return gCell_; }
     GNet* gNet() const { return gNet_; }
@@ -443,7 +458,7 @@ class GPin {
   private:
     GCell* gCell_;
     GNet* gNet_;
-    std::vector<Pin*> pins_;
+    PointerRange<Pin> pins_;
 
     int offsetCx_;
     int offsetCy_;
@@ -619,6 +634,48 @@ Bin::addFillerArea(int64_t area) {
   fillerArea_ += area;
 }
 
+//
+// Filler GCells' density coordinates in a contiguous array,
+// indexed as NesterovBase::gCellFillers().
+// All fillers share the same density size and scale,
+// so only the lower-left corners are stored per filler.
+//
+class FillerDensity {
+public:
+  std::vector<IntPoint> lowerLefts;
+  int dDx;
+  int dDy;
+  float densityScale;
+
+  FillerDensity();
+};
+
+// Density kernel variants of BinGrid::updateBinsGCellDensityArea
+enum class DensityCellClass {
+  // area * densityScale * bin's targetDensity
+  Macro,
+  // area; density size is the cell size (densityScale is 1)
+  Std,
+  // area * densityScale; inflated to sqrt(2) bins
+  ScaledStd,
+  // area * densityScale, added to the bins' fillerArea
+  Filler
+};
+
+//
+// Instance gCells partitioned by DensityCellClass,
+// so each class runs its own kernel without per-cell branches.
+// Classes are fixed once density sizes are set in NesterovBase::init.
+//
+class InstDensityCells {
+public:
+  std::vector<GCell*> macros;
+  std::vector<GCell*> stdCells;
+  std::vector<GCell*> scaledStdCells;
+
+  void clear();
+};
+
 //
 // The bin can be non-uniform because of
 // "integer" coordinates
@@ -635,8 +692,15 @@ public:
   void setBinCnt(int binCntX, int binCntY);
   void setBinCntX(int binCntX);
   void setBinCntY(int binCntY);
+  // bin counts are found by initBins
+  void unsetBinCnt();
   void setTargetDensity(float density);
-  void updateBinsGCellDensityArea(std::vector<GCell*>& cells);
+
+  // instance gCells are accumulated per class, and fillers
+  // with their shared size and scale.
+  void updateBinsGCellDensityArea(
+      const InstDensityCells& cells,
+      const FillerDensity& fillers);
 
 
   void initBins();
@@ -661,14 +725,18 @@ public:
   // return bins_ index with given gcell
   std::pair<int, int> getDensityMinMaxIdxX(GCell* gcell);
   std::pair<int, int> getDensityMinMaxIdxY(GCell* gcell);
+  std::pair<int, int> getDensityMinMaxIdxX(int dLx, int dUx);
+  std::pair<int, int> getDensityMinMaxIdxY(int dLy, int dUy);
 
   std::pair<int, int> getMinMaxIdxX(Instance* inst);
   std::pair<int, int> getMinMaxIdxY(Instance* inst);
 
   const std::vector<Bin*> & bins() const;
 
+  int64_t memoryBytes() const;
+
 private:
-  std::vector<Bin> binStor_;
+  std::vector<Bin, LargeArrayAllocator<Bin>> binStor_;
   std::vector<Bin*> bins_;
   std::shared_ptr<PlacerBase> pb_;
   std::shared_ptr<Logger> log_;
@@ -686,6 +754,10 @@ private:
   unsigned char isSetBinCntY_:1;
 
   void updateBinsNonPlaceArea();
+
+  // adds a cell's overlap area to bins (See DensityCellClass)
+  template <DensityCellClass cellClass>
+  void addDensityArea(int dLx, int dLy, int dUx, int dUy, float scale);
 };
 
 inline const std::vector<Bin*> & BinGrid::bins() const {
@@ -700,6 +772,9 @@ public:
   int binCntX;
   int binCntY;
   float minWireLengthForceBar;
+  // fillers start 2^level x 2^level times larger (same total area)
+  // and are split by NesterovBase::splitFillerGCells. 0 disables it.
+  int coarseFillerLevel;
   unsigned char isSetBinCntX:1;
   unsigned char isSetBinCntY:1;
 
@@ -714,6 +789,14 @@ public:
       std::shared_ptr<Logger> log);
   ~NesterovBase();
 
+  // Patch G-objects after PlacerBase::sync() on the same PlacerBase.
+  // G-objects of removed Instances/Pins/Nets are dropped, 
+  // new ones are appended, and all are relinked to PlacerBase's
+  // lists and refreshed from them. Kept G-objects stay in their
+  // order (e.g. locality order). Fillers and bins are rebuilt
+  // with nbVars, and the FFT is kept on the same bins.
+  void sync(NesterovBaseVars nbVars, std::shared_ptr<Logger> log);
+
   const std::vector<GCell*> & gCells() const { return gCells_; }
   const std::vector<GCell*> & gCellInsts() const { return gCellInsts_; }
   const std::vector<GCell*> & gCellFillers() const { return gCellFillers_; }
@@ -730,14 +813,30 @@ public:
 
   // update gCells with lx, ly
   void updateGCellLocation(
-      std::vector<FloatPoint>& points);
+      FloatPointArray& points);
 
   // update gCells with cx, cy
   void updateGCellCenterLocation(
-      std::vector<FloatPoint>& points);
+      FloatPointArray& points);
 
   void updateGCellDensityCenterLocation(
-      std::vector<FloatPoint>& points);
+      FloatPointArray& points);
+
+  // Fused Nesterov coordinate update kernel.
+  //
+  // nextCoordi    = curSLPCoordi + stepLength * curSLPSumGrads
+  // nextSLPCoordi = nextCoordi + coeff * (nextCoordi - curCoordi)
+  //
+  // Both are clamped inside the layout, and nextSLPCoordi is
+  // committed into gCells' density coordinates in the same pass.
+  // GPins' coordinates are refreshed lazily in updateWireLengthForceWA.
+  void updateNextCoordi(
+      const FloatPointArray& curSLPCoordi,
+      const FloatPointArray& curSLPSumGrads,
+      const FloatPointArray& curCoordi,
+      float stepLength, float coeff,
+      FloatPointArray& nextCoordi,
+      FloatPointArray& nextSLPCoordi);
 
   int binCntX() const;
   int binCntY() const;
@@ -785,11 +884,45 @@ public:
   FloatPoint
     getDensityGradient(GCell* gCell);
 
+  // Split every filler into 2x2 fillers of half size.
+  // The first child stays at the filler's gCells() index and the
+  // other three are appended in filler order (See getFillerSplitOffset).
+  // returns false if fillers are already at the finest level.
+  bool splitFillerGCells();
+  int coarseFillerLevel() const { return coarseFillerLevel_; }
+
+  // child's center offset from its parent filler's center,
+  // child = 0..3, valid after splitFillerGCells.
+  FloatPoint getFillerSplitOffset(int child) const;
+
+  // same as getDensityGradient(gCellFillers()[fillerIdx]),
+  // but reads the contiguous filler array.
+  // Valid after updateGCellDensityCenterLocation/updateNextCoordi.
+  FloatPoint
+    getFillerDensityGradient(int fillerIdx);
+
   int64_t getHpwl();
 
   // update electrostatic forces within Bin
   void updateDensityForceBin();
 
+  // Locality reordering.
+  //
+  // Sort gCells by the Hilbert key of their density centers
+  // (instances and fillers separately, so fillers stay the tail),
+  // and renumber gPins/gNets in the order they are reached from
+  // the sorted gCells. G-objects' coordinates are unchanged.
+  //
+  // newToOld[i] is the previous gCells() index of gCells()[i],
+  // to permute per-gCell vectors of the caller.
+  void reorderForLocality(std::vector<int>& newToOld);
+
+  // heap bytes (capacity based).
+  // memoryBytes() : G-objects, their pin/net lists and maps
+  int64_t memoryBytes() const;
+  int64_t binGridMemoryBytes() const { return bg_.memoryBytes(); }
+  int64_t fftMemoryBytes() const;
+
 private:
   NesterovBaseVars nbVars_;
   std::shared_ptr<PlacerBase> pb_;
@@ -806,18 +939,63 @@ private:
   std::vector<GCell*> gCellInsts_;
   std::vector<GCell*> gCellFillers_;
 
+  // fillers' density coordinates for the density kernels.
+  // refreshed whenever gCells' density coordinates are committed.
+  FillerDensity fillerDensity_;
+
+  // gCellInsts_ by density kernel. 
+  // rebuilt when gCellInsts_ is reordered.
+  InstDensityCells instDensityCells_;
+
+  // remaining splits of the coarse fillers
+  int coarseFillerLevel_;
+  // number of fillers without coarse fillers.
+  // The last split keeps this many fillers.
+  int fineFillerCnt_;
+
   std::vector<GNet*> gNets_;
   std::vector<GPin*> gPins_;
 
-  std::unordered_map<Instance*, GCell*> gCellMap_;
-  std::unordered_map<Pin*, GPin*> gPinMap_;
-  std::unordered_map<Net*, GNet*> gNetMap_;
+  // gCells' and gNets' gPin lists, concatenated in 
+  // gCellStor_/gNetStor_ order. GCell/GNet hold ranges of them.
+  std::vector<GPin*> gCellGPinStor_;
+  std::vector<GPin*> gNetGPinStor_;
+
+  // Instance/Pin/Net to G-object references, indexed by 
+  // PlacerBase::instIndex/pinIndex/netIndex.
+  // nullptr if the instance is not placeable or the index is 
+  // a removed object's.
+  // G-objects are stored in PlacerBase's order until 
+  // reorderForLocality or sync is called.
+  std::vector<GCell*> gCellIdMap_;
+  std::vector<GPin*> gPinIdMap_;
+  std::vector<GNet*> gNetIdMap_;
+
+  // valid range of gCells' density center coordinates 
+  // to stay inside the layout. Indexed as gCells_.
+  FloatPointArray densityCoordiLowerBounds_;
+  FloatPointArray densityCoordiUpperBounds_;
 
   float sumPhi_;
 
+  // gCells are moved without updating gPins
+  // in updateNextCoordi
+  bool isGPinDensityLocationStale_;
+
   void init();
+  void initGObjects();
   void initFillerGCells();
+  void initGPinLists();
   void initBinGrid();
+  void initDensityCoordiBounds();
+  void initFillerDensity();
+  void initInstDensityCells();
+
+  void updateDensitySize(GCell* gCell);
+
+  void updateFillerDensityLocations();
+
+  void updateGPinsDensityLocation();
 
   void reset();
 };
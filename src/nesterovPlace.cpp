@@ -3,7 +3,9 @@
 #include "nesterovPlace.h"
 #include "opendb/db.h"
 #include "logger.h"
+#include "metricsWriter.h"
 #include <iostream>
+#include <chrono>
 using namespace std;
 
 #include "plot.h"
@@ -11,10 +13,24 @@ using namespace std;
 namespace replace {
 
 static float
-getDistance(vector<FloatPoint>& a, vector<FloatPoint>& b);
+getDistance(FloatPointArray& a, FloatPointArray& b);
 
-static float
-getSecondNorm(vector<FloatPoint>& a);
+static double
+getElapsedMs(std::chrono::steady_clock::time_point startTime);
+
+static void
+splitFillerVector(FloatPointArray& vec,
+    int fillerBegin, int prevSize, int size,
+    const FloatPoint* offsets);
+
+static void
+permuteVector(FloatPointArray& vec, 
+    const vector<int>& newToOld,
+    FloatPointArray& work);
+
+// gCells per block of updateGradients' partial sums.
+// Fixed, so the sums don't depend on the number of threads.
+static const int gradSumBlockSize = 1024;
 
 NesterovPlaceVars::NesterovPlaceVars()
   : maxNesterovIter(2000), 
@@ -26,12 +42,17 @@ NesterovPlaceVars::NesterovPlaceVars()
   maxPhiCoef(1.05),
   minPreconditioner(1.0),
   initialPrevCoordiUpdateCoef(100),
-  referenceHpwl(446000000) {}
+  referenceHpwl(446000000),
+  fillerSplitOverflow(0.5),
+  localityOrder(false),
+  localityOrderInterval(0),
+  metricsFile("") {}
 
 NesterovPlace::NesterovPlace() 
   : pb_(nullptr), nb_(nullptr), log_(nullptr), npVars_(), 
   wireLengthGradSum_(0), 
   densityGradSum_(0),
+  sumGradNorm_(0),
   stepLength_(0),
   densityPenalty_(0),
   baseWireLengthCoef_(0), 
@@ -63,6 +84,7 @@ static PlotEnv pe;
 
 void NesterovPlace::init() {
   log_->procBegin("NesterovInit", 3);
+  ProfileScope scope(log_, "NesterovInit");
 
   const int gCellSize = nb_->gCells().size();
   curSLPCoordi_.resize(gCellSize, FloatPoint());
@@ -83,6 +105,8 @@ void NesterovPlace::init() {
   curCoordi_.resize(gCellSize, FloatPoint());
   nextCoordi_.resize(gCellSize, FloatPoint());
 
+  initPreconditioners();
+
   for(auto& gCell : nb_->gCells()) {
     nb_->updateDensityCoordiLayoutInside( gCell );
     int idx = &gCell - &nb_->gCells()[0];
@@ -92,6 +116,11 @@ void NesterovPlace::init() {
       = FloatPoint(gCell->dCx(), gCell->dCy()); 
   }
 
+  // gCells are at the initial place result here
+  if( npVars_.localityOrder ) {
+    reorderForLocality();
+  }
+
   // bin update
   nb_->updateGCellDensityCenterLocation(curSLPCoordi_);
   
@@ -174,6 +203,93 @@ void NesterovPlace::init() {
   log_->procEnd("NesterovInit", 3);
 }
 
+// preconditioners never change during the Nesterov loop.
+void NesterovPlace::initPreconditioners() {
+  const int gCellSize = nb_->gCells().size();
+  wireLengthPrecondi_.resize(gCellSize, FloatPoint());
+  densityPrecondi_.resize(gCellSize, FloatPoint());
+
+  for(int i=0; i<gCellSize; i++) {
+    GCell* gCell = nb_->gCells()[i];
+    wireLengthPrecondi_[i] = nb_->getWireLengthPreconditioner(gCell);
+    densityPrecondi_[i] = nb_->getDensityPreconditioner(gCell);
+  }
+}
+
+// Split coarse fillers (See NesterovBase::splitFillerGCells).
+// Children inherit their parent's coordinates shifted by 
+// the same offset, so the Nesterov momentum (coordinate 
+// differences) carries over. The gradients at curSLPCoordi_ 
+// are recomputed for the new gCells.
+void NesterovPlace::splitFillerGCells() {
+  ProfileScope scope(log_, "FillerSplit");
+
+  const int fillerBegin = nb_->gCellInsts().size();
+  const int prevSize = nb_->gCells().size();
+  if( !nb_->splitFillerGCells() ) {
+    return;
+  }
+  const int size = nb_->gCells().size();
+
+  FloatPoint offsets[4];
+  for(int child=0; child<4; child++) {
+    offsets[child] = nb_->getFillerSplitOffset(child);
+  }
+  const FloatPoint noOffsets[4];
+
+  FloatPointArray* coordis[] = {
+    &curSLPCoordi_, &nextSLPCoordi_, &prevSLPCoordi_,
+    &curCoordi_, &nextCoordi_ };
+  for(auto& coordi : coordis) {
+    splitFillerVector(*coordi, fillerBegin, prevSize, size, offsets);
+    for(int k=fillerBegin; k<size; k++) {
+      GCell* gCell = nb_->gCells()[k];
+      (*coordi)[k].x = nb_->getDensityCoordiLayoutInsideX(gCell, (*coordi)[k].x);
+      (*coordi)[k].y = nb_->getDensityCoordiLayoutInsideY(gCell, (*coordi)[k].y);
+    }
+  }
+
+  FloatPointArray* grads[] = {
+    &curSLPWireLengthGrads_, &curSLPDensityGrads_, &curSLPSumGrads_,
+    &nextSLPWireLengthGrads_, &nextSLPDensityGrads_, &nextSLPSumGrads_,
+    &prevSLPWireLengthGrads_, &prevSLPDensityGrads_, &prevSLPSumGrads_ };
+  for(auto& grad : grads) {
+    splitFillerVector(*grad, fillerBegin, prevSize, size, noOffsets);
+  }
+
+  initPreconditioners();
+
+  nb_->updateGCellDensityCenterLocation(curSLPCoordi_);
+  nb_->updateDensityForceBin();
+  nb_->updateWireLengthForceWA(wireLengthCoefX_, wireLengthCoefY_);
+  updateGradients(curSLPSumGrads_, curSLPWireLengthGrads_, 
+      curSLPDensityGrads_);
+
+  log_->infoInt("FillerSplit: NumGCells", size);
+}
+
+// gCells are moved in NesterovBase, 
+// so every per-gCell vector follows the same permutation.
+void NesterovPlace::reorderForLocality() {
+  vector<int> newToOld;
+  nb_->reorderForLocality(newToOld);
+
+  FloatPointArray* vecs[] = {
+    &curSLPCoordi_, &curSLPWireLengthGrads_, 
+    &curSLPDensityGrads_, &curSLPSumGrads_,
+    &nextSLPCoordi_, &nextSLPWireLengthGrads_, 
+    &nextSLPDensityGrads_, &nextSLPSumGrads_,
+    &prevSLPCoordi_, &prevSLPWireLengthGrads_, 
+    &prevSLPDensityGrads_, &prevSLPSumGrads_,
+    &curCoordi_, &nextCoordi_,
+    &wireLengthPrecondi_, &densityPrecondi_ };
+
+  FloatPointArray work;
+  for(auto& vec : vecs) {
+    permuteVector(*vec, newToOld, work);
+  }
+}
+
 // clear reset
 void NesterovPlace::reset() {
 
@@ -194,6 +310,9 @@ void NesterovPlace::reset() {
   
   curCoordi_.clear();
   nextCoordi_.clear();
+
+  wireLengthPrecondi_.clear();
+  densityPrecondi_.clear();
 }
 
 // to execute following function,
@@ -205,60 +324,104 @@ void NesterovPlace::reset() {
 //
 void
 NesterovPlace::updateGradients(
-    std::vector<FloatPoint>& sumGrads,
-    std::vector<FloatPoint>& wireLengthGrads,
-    std::vector<FloatPoint>& densityGrads) {
-
-  wireLengthGradSum_ = 0;
-  densityGradSum_ = 0;
-
-  float gradSum = 0;
+    FloatPointArray& sumGrads,
+    FloatPointArray& wireLengthGrads,
+    FloatPointArray& densityGrads) {
+  ProfileScope scope(log_, "Gradients");
 
   log_->infoFloatSignificant("  DensityPenalty", densityPenalty_, 3);
 
-  for(size_t i=0; i<nb_->gCells().size(); i++) {
-    GCell* gCell = nb_->gCells().at(i);
-    wireLengthGrads[i] = nb_->getWireLengthGradientWA(
-        gCell, wireLengthCoefX_, wireLengthCoefY_);
-    densityGrads[i] = nb_->getDensityGradient(gCell); 
-
-    // Different compiler has different results on the following formula.
-    // e.g. wireLengthGradSum_ += fabs(~~.x) + fabs(~~.y);
-    //
-    // To prevent instability problem,
-    // I partitioned the fabs(~~.x) + fabs(~~.y) as two terms.
-    //
-    wireLengthGradSum_ += fabs(wireLengthGrads[i].x);
-    wireLengthGradSum_ += fabs(wireLengthGrads[i].y);
-      
-    densityGradSum_ += fabs(densityGrads[i].x);
-    densityGradSum_ += fabs(densityGrads[i].y);
-
-    sumGrads[i].x = wireLengthGrads[i].x + densityPenalty_ * densityGrads[i].x;
-    sumGrads[i].y = wireLengthGrads[i].y + densityPenalty_ * densityGrads[i].y;
+  const int gCellSize = nb_->gCells().size();
+  const int fillerBegin = nb_->gCellInsts().size();
+  const float minPrecondi = npVars_.minPreconditioner;
+
+  // gradient sums of a block of gCells, in double.
+  // A float reduction combines threads' sums in an order that depends 
+  // on the thread count, and wireLengthGradSum_/densityGradSum_ set
+  // the initial density penalty. So the blocks' partial sums are 
+  // added serially in block order instead.
+  struct GradSums {
+    double wireLength;
+    double density;
+    double grad;
+    double gradSquare;
+    GradSums() : wireLength(0), density(0), grad(0), gradSquare(0) {}
+  };
+  const int blockCnt 
+    = (gCellSize + gradSumBlockSize - 1) / gradSumBlockSize;
+  vector<GradSums> blockSums(blockCnt);
+
+  // gradients, preconditioning and gradient sums in a single pass.
+  // each iteration only reads nb_'s bins/gNets and writes its own index.
+  // fillers (the tail of gCells) have no wirelength gradient.
+#pragma omp parallel for schedule(static)
+  for(int b=0; b<blockCnt; b++) {
+    const int blockEnd = std::min((b+1) * gradSumBlockSize, gCellSize);
+    GradSums& sums = blockSums[b];
+    for(int i=b*gradSumBlockSize; i<blockEnd; i++) {
+      if( i < fillerBegin ) {
+        GCell* gCell = nb_->gCells()[i];
+        wireLengthGrads[i] = nb_->getWireLengthGradientWA(
+            gCell, wireLengthCoefX_, wireLengthCoefY_);
+        densityGrads[i] = nb_->getDensityGradient(gCell); 
+      }
+      else {
+        wireLengthGrads[i] = FloatPoint();
+        densityGrads[i] = nb_->getFillerDensityGradient(i - fillerBegin);
+      }
 
-    FloatPoint wireLengthPreCondi 
-      = nb_->getWireLengthPreconditioner(gCell);
-    FloatPoint densityPrecondi
-      = nb_->getDensityPreconditioner(gCell);
+      // Different compiler has different results on the following formula.
+      // e.g. wireLengthGradSum_ += fabs(~~.x) + fabs(~~.y);
+      //
+      // To prevent instability problem,
+      // I partitioned the fabs(~~.x) + fabs(~~.y) as two terms.
+      //
+      sums.wireLength += fabs(wireLengthGrads[i].x);
+      sums.wireLength += fabs(wireLengthGrads[i].y);
+        
+      sums.density += fabs(densityGrads[i].x);
+      sums.density += fabs(densityGrads[i].y);
 
-    FloatPoint sumPrecondi(
-        wireLengthPreCondi.x + densityPenalty_ * densityPrecondi.x,
-        wireLengthPreCondi.y + densityPenalty_ * densityPrecondi.y);
+      float sumPrecondiX = wireLengthPrecondi_[i].x 
+        + densityPenalty_ * densityPrecondi_[i].x;
+      float sumPrecondiY = wireLengthPrecondi_[i].y 
+        + densityPenalty_ * densityPrecondi_[i].y;
 
-    if( sumPrecondi.x <= npVars_.minPreconditioner ) {
-      sumPrecondi.x = npVars_.minPreconditioner;
-    }
+      if( sumPrecondiX <= minPrecondi ) {
+        sumPrecondiX = minPrecondi;
+      }
 
-    if( sumPrecondi.y <= npVars_.minPreconditioner ) {
-      sumPrecondi.y = npVars_.minPreconditioner; 
+      if( sumPrecondiY <= minPrecondi ) {
+        sumPrecondiY = minPrecondi; 
+      }
+      
+      sumGrads[i].x = (wireLengthGrads[i].x 
+          + densityPenalty_ * densityGrads[i].x) / sumPrecondiX;
+      sumGrads[i].y = (wireLengthGrads[i].y 
+          + densityPenalty_ * densityGrads[i].y) / sumPrecondiY;
+
+      sums.grad += fabs(sumGrads[i].x);
+      sums.grad += fabs(sumGrads[i].y);
+      sums.gradSquare += sumGrads[i].x * sumGrads[i].x;
+      sums.gradSquare += sumGrads[i].y * sumGrads[i].y;
     }
-    
-    sumGrads[i].x /= sumPrecondi.x;
-    sumGrads[i].y /= sumPrecondi.y; 
+  }
 
-    gradSum += fabs(sumGrads[i].x) + fabs(sumGrads[i].y);
+  double wireLengthGradSum = 0;
+  double densityGradSum = 0;
+  double gradSum = 0;
+  double gradSquareSum = 0;
+  for(auto& sums : blockSums) {
+    wireLengthGradSum += sums.wireLength;
+    densityGradSum += sums.density;
+    gradSum += sums.grad;
+    gradSquareSum += sums.gradSquare;
   }
+
+  wireLengthGradSum_ = wireLengthGradSum;
+  densityGradSum_ = densityGradSum;
+  sumGradNorm_ = (gCellSize > 0)? 
+    sqrt( gradSquareSum / (2.0 * gCellSize) ) : 0;
   
   log_->infoFloatSignificant("  WireLengthGradSum", wireLengthGradSum_, 3);
   log_->infoFloatSignificant("  DensityGradSum", densityGradSum_, 3);
@@ -283,6 +446,8 @@ NesterovPlace::doNesterovPlace() {
     return;
   }
 
+  ProfileScope scope(log_, "NesterovPlace");
+
 #ifdef ENABLE_CIMG_LIB  
   pe.setPlacerBase(pb_);
   pe.setNesterovBase(nb_);
@@ -311,9 +476,50 @@ NesterovPlace::doNesterovPlace() {
   string divergeMsg = "";
   int divergeCode = 0;
 
+  // coarse fillers are split as overflow drops
+  const int initFillerLevel = nb_->coarseFillerLevel();
+
+  MetricsWriter metricsWriter;
+  if( !npVars_.metricsFile.empty()
+      && !metricsWriter.open(npVars_.metricsFile) ) {
+    log_->warn("Cannot open metrics file: " + npVars_.metricsFile, 9);
+  }
+
   // Core Nesterov Loop
   for(int i=0; i<npVars_.maxNesterovIter; i++) {
     log_->infoInt("Iter", i+1, 3);
+    auto iterStartTime = std::chrono::steady_clock::now();
+
+    // profiler phases of this iteration's backtracking steps
+    double densityAreaTime = 0;
+    double densityFFTTime = 0;
+    double wireLengthTime = 0;
+    double gradientTime = 0;
+
+    auto pushMetrics = [&](int backTrackCnt, double backTrackTime,
+        double updateNextIterTime) {
+      if( !metricsWriter.isOpen() ) {
+        return;
+      }
+      IterMetrics metrics;
+      metrics.iter = i+1;
+      metrics.overflow = sumOverflow_;
+      metrics.hpwl = prevHpwl_;
+      metrics.stepLength = stepLength_;
+      metrics.densityPenalty = densityPenalty_;
+      metrics.backTrackCnt = backTrackCnt;
+      metrics.wireLengthGradSum = wireLengthGradSum_;
+      metrics.densityGradSum = densityGradSum_;
+      metrics.gradNorm = sumGradNorm_;
+      metrics.backTrackTime = backTrackTime;
+      metrics.updateNextIterTime = updateNextIterTime;
+      metrics.iterTime = getElapsedMs(iterStartTime);
+      metrics.densityAreaTime = densityAreaTime;
+      metrics.densityFFTTime = densityFFTTime;
+      metrics.wireLengthTime = wireLengthTime;
+      metrics.gradientTime = gradientTime;
+      metricsWriter.push(metrics);
+    };
     
     float prevA = curA;
 
@@ -330,39 +536,23 @@ NesterovPlace::doNesterovPlace() {
     log_->infoFloatSignificant("  Coefficient", coeff, 3);
     log_->infoFloatSignificant("  StepLength", stepLength_, 3);
 
+    densityAreaTime = log_->profileWallTime("DensityArea");
+    densityFFTTime = log_->profileWallTime("DensityFFT");
+    wireLengthTime = log_->profileWallTime("WireLengthWA");
+    gradientTime = log_->profileWallTime("Gradients");
+
     // Back-Tracking loop
+    log_->profileBegin("BackTracking");
     int numBackTrak = 0;
     for(numBackTrak = 0; numBackTrak < npVars_.maxBackTrack; numBackTrak++) {
       
       // fill in nextCoordinates with given stepLength_
-      for(size_t k=0; k<nb_->gCells().size(); k++) {
-        FloatPoint nextCoordi(
-          curSLPCoordi_[k].x + stepLength_ * curSLPSumGrads_[k].x,
-          curSLPCoordi_[k].y + stepLength_ * curSLPSumGrads_[k].y );
-
-        FloatPoint nextSLPCoordi(
-          nextCoordi.x + coeff * (nextCoordi.x - curCoordi_[k].x),
-          nextCoordi.y + coeff * (nextCoordi.y - curCoordi_[k].y));
-
-        GCell* curGCell = nb_->gCells()[k];
-
-        nextCoordi_[k] 
-          = FloatPoint( 
-              nb_->getDensityCoordiLayoutInsideX( 
-                curGCell, nextCoordi.x),
-              nb_->getDensityCoordiLayoutInsideY(
-                curGCell, nextCoordi.y));
-        
-        nextSLPCoordi_[k]
-          = FloatPoint(
-              nb_->getDensityCoordiLayoutInsideX(
-                curGCell, nextSLPCoordi.x),
-              nb_->getDensityCoordiLayoutInsideY(
-                curGCell, nextSLPCoordi.y));
-      }
- 
+      // and move gCells to nextSLPCoordi_ (bin update)
+      nb_->updateNextCoordi(
+          curSLPCoordi_, curSLPSumGrads_, curCoordi_,
+          stepLength_, coeff,
+          nextCoordi_, nextSLPCoordi_);
 
-      nb_->updateGCellDensityCenterLocation(nextSLPCoordi_);
       nb_->updateDensityForceBin();
       nb_->updateWireLengthForceWA(wireLengthCoefX_, wireLengthCoefY_);
 
@@ -387,7 +577,19 @@ NesterovPlace::doNesterovPlace() {
       } 
     }
 
+    log_->profileEnd();
     log_->infoInt("  NumBackTrak", numBackTrak+1, 3);
+    const double backTrackTime = getElapsedMs(iterStartTime);
+
+    // ms of the phases' totals since the backtracking began
+    densityAreaTime 
+      = (log_->profileWallTime("DensityArea") - densityAreaTime) * 1000;
+    densityFFTTime 
+      = (log_->profileWallTime("DensityFFT") - densityFFTTime) * 1000;
+    wireLengthTime 
+      = (log_->profileWallTime("WireLengthWA") - wireLengthTime) * 1000;
+    gradientTime 
+      = (log_->profileWallTime("Gradients") - gradientTime) * 1000;
 
     // dynamic adjustment for
     // better convergence with
@@ -408,11 +610,21 @@ NesterovPlace::doNesterovPlace() {
       isDiverged_ = true;
     } 
 
+    // the diverging iteration is recorded as well;
+    // it has no UpdateNextIter.
     if( isDiverged_ ) {
+      pushMetrics(numBackTrak+1, backTrackTime, 0);
       break;
     }
 
-    updateNextIter(); 
+    auto updateStartTime = std::chrono::steady_clock::now();
+    {
+      ProfileScope scope(log_, "UpdateNextIter");
+      updateNextIter(); 
+    }
+
+    pushMetrics(numBackTrak+1, backTrackTime, 
+        getElapsedMs(updateStartTime));
 
 
     // For JPEG Saving
@@ -455,6 +667,28 @@ NesterovPlace::doNesterovPlace() {
       break;
     }
 
+    if( npVars_.localityOrder && npVars_.localityOrderInterval > 0 
+        && (i+1) % npVars_.localityOrderInterval == 0 ) {
+      reorderForLocality();
+    }
+
+    // split coarse fillers; 
+    // fillers must be at the finest level to finish.
+    const int fillerLevel = nb_->coarseFillerLevel();
+    if( fillerLevel > 0 
+        && ( sumOverflow_ < npVars_.fillerSplitOverflow 
+          * fillerLevel / initFillerLevel 
+          || sumOverflow_ <= npVars_.targetOverflow ) ) {
+      splitFillerGCells();
+      if( isDiverged_ ) {
+        divergeMsg = "RePlAce divergence detected. \n";
+        divergeMsg += "        Please decrease init_density_penalty value";
+        divergeCode = 3;
+        break;
+      }
+      continue;
+    }
+
     // minimum iteration is 50
     if( i > 50 && sumOverflow_ <= npVars_.targetOverflow) {
       cout << "[NesterovSolve] Finished with Overflow: " << sumOverflow_ << endl;
@@ -464,9 +698,14 @@ NesterovPlace::doNesterovPlace() {
  
   // in all case including diverge, 
   // db should be updated. 
-  updateDb();
+  {
+    ProfileScope scope(log_, "UpdateDb");
+    updateDb();
+  }
 
   if( isDiverged_ ) { 
+    // error() exits; flush the pending records first.
+    metricsWriter.close();
     log_->error(divergeMsg, divergeCode);
   }
 }
@@ -531,7 +770,9 @@ NesterovPlace::updateNextIter() {
         / static_cast<float>(pb_->stdInstsArea() 
             + pb_->macroInstsArea() * nb_->targetDensity() );
 
-  log_->infoFloatSignificant("  Gradient", getSecondNorm(curSLPSumGrads_), 3);
+  if( log_->isEnabled(3) ) {
+    log_->infoFloatSignificant("  Gradient", sumGradNorm_, 3);
+  }
   log_->infoFloatSignificant("  Phi", nb_->sumPhi(), 3);
   log_->infoFloatSignificant("  Overflow", sumOverflow_, 3);
 
@@ -554,10 +795,10 @@ NesterovPlace::updateNextIter() {
 
 float
 NesterovPlace::getStepLength(
-    std::vector<FloatPoint>& prevSLPCoordi_,
-    std::vector<FloatPoint>& prevSLPSumGrads_,
-    std::vector<FloatPoint>& curSLPCoordi_,
-    std::vector<FloatPoint>& curSLPSumGrads_ ) {
+    FloatPointArray& prevSLPCoordi_,
+    FloatPointArray& prevSLPSumGrads_,
+    FloatPointArray& curSLPCoordi_,
+    FloatPointArray& curSLPSumGrads_ ) {
 
   float coordiDistance 
     = getDistance(prevSLPCoordi_, curSLPCoordi_);
@@ -582,13 +823,34 @@ NesterovPlace::getPhiCoef(float scaledDiffHpwl) {
   return retCoef;
 }
 
+int64_t
+NesterovPlace::memoryBytes() const {
+  return getCapacityBytes(curSLPCoordi_)
+    + getCapacityBytes(curSLPWireLengthGrads_)
+    + getCapacityBytes(curSLPDensityGrads_)
+    + getCapacityBytes(curSLPSumGrads_)
+    + getCapacityBytes(nextSLPCoordi_)
+    + getCapacityBytes(nextSLPWireLengthGrads_)
+    + getCapacityBytes(nextSLPDensityGrads_)
+    + getCapacityBytes(nextSLPSumGrads_)
+    + getCapacityBytes(prevSLPCoordi_)
+    + getCapacityBytes(prevSLPWireLengthGrads_)
+    + getCapacityBytes(prevSLPDensityGrads_)
+    + getCapacityBytes(prevSLPSumGrads_)
+    + getCapacityBytes(curCoordi_)
+    + getCapacityBytes(nextCoordi_)
+    + getCapacityBytes(wireLengthPrecondi_)
+    + getCapacityBytes(densityPrecondi_);
+}
+
 void
 NesterovPlace::updateDb() {
   for(auto& gCell : nb_->gCells()) {
     if( gCell->isInstance() ) {
-      odb::dbInst* inst = gCell->instance()->dbInst();
-      inst->setPlacementStatus(odb::dbPlacementStatus::PLACED); 
-      inst->setLocation( gCell->dCx()-gCell->dDx()/2,
+      // db-less instances only update their own locations
+      Instance* inst = gCell->instance();
+      inst->dbSetPlaced(); 
+      inst->dbSetLocation( gCell->dCx()-gCell->dDx()/2,
            gCell->dCy()-gCell->dDy()/2 ); 
     }
   }
@@ -596,7 +858,7 @@ NesterovPlace::updateDb() {
 
 
 static float
-getDistance(vector<FloatPoint>& a, vector<FloatPoint>& b) {
+getDistance(FloatPointArray& a, FloatPointArray& b) {
   float sumDistance = 0.0f;
   for(size_t i=0; i<a.size(); i++) {
     sumDistance += (a[i].x - b[i].x) * (a[i].x - b[i].x);
@@ -606,13 +868,46 @@ getDistance(vector<FloatPoint>& a, vector<FloatPoint>& b) {
   return sqrt( sumDistance / (2.0 * a.size()) );
 }
 
-static float
-getSecondNorm(vector<FloatPoint>& a) {
-  float norm = 0;
-  for(auto& coordi : a) {
-    norm += coordi.x * coordi.x + coordi.y * coordi.y;
+// fillers [fillerBegin, prevSize) are split into 
+// 4 children; child 0 stays at the filler's index and 
+// children 1-3 are appended in filler order up to size.
+static void
+splitFillerVector(FloatPointArray& vec,
+    int fillerBegin, int prevSize, int size,
+    const FloatPoint* offsets) {
+  vec.resize(size, FloatPoint());
+  for(int k=fillerBegin; k<prevSize; k++) {
+    const FloatPoint parent = vec[k];
+    for(int child=1; child<4; child++) {
+      const int childIdx = prevSize + 3 * (k - fillerBegin) + child - 1;
+      if( childIdx >= size ) {
+        break;
+      }
+      vec[childIdx] 
+        = FloatPoint(parent.x + offsets[child].x, 
+            parent.y + offsets[child].y);
+    }
+    vec[k] = FloatPoint(parent.x + offsets[0].x, 
+        parent.y + offsets[0].y);
   }
-  return sqrt( norm / (2.0*a.size()) ); 
+}
+
+// vec[i] = prevVec[newToOld[i]]; work is a scratch vector.
+static void
+permuteVector(FloatPointArray& vec, 
+    const vector<int>& newToOld,
+    FloatPointArray& work) {
+  work.resize(vec.size());
+  for(size_t i=0; i<newToOld.size(); i++) {
+    work[i] = vec[newToOld[i]];
+  }
+  vec.swap(work);
+}
+
+static double
+getElapsedMs(std::chrono::steady_clock::time_point startTime) {
+  return std::chrono::duration<double, std::milli>(
+      std::chrono::steady_clock::now() - startTime).count();
 }
 
 
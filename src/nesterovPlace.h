@@ -4,6 +4,7 @@
 #include "point.h"
 #include <memory>
 #include <vector>
+#include <string>
 
 namespace replace
 {
@@ -25,6 +26,21 @@ class NesterovPlaceVars {
   float minPreconditioner; // MIN_PRE
   float initialPrevCoordiUpdateCoef; // z_ref_alpha
   float referenceHpwl; // refDeltaHpwl
+
+  // coarse fillers (See NesterovBaseVars::coarseFillerLevel) 
+  // are split one level each time the overflow drops below
+  // fillerSplitOverflow * remainingLevels / initialLevels.
+  float fillerSplitOverflow;
+
+  // sort gCells/gPins/gNets by location after init
+  // (See NesterovBase::reorderForLocality), and again
+  // every localityOrderInterval iterations if > 0.
+  bool localityOrder;
+  int localityOrderInterval;
+
+  // per-iteration metrics file (See MetricsWriter).
+  // empty disables it.
+  std::string metricsFile;
   NesterovPlaceVars();
 };
 
@@ -40,30 +56,33 @@ public:
   void doNesterovPlace();
 
   void updateCoordi(
-      std::vector<FloatPoint>& coordi);
+      FloatPointArray& coordi);
   void updateBins();
   void updateWireLength();
 
   void updateGradients(
-      std::vector<FloatPoint>& sumGrads,
-      std::vector<FloatPoint>& wireLengthGrads,
-      std::vector<FloatPoint>& densityGrads );
+      FloatPointArray& sumGrads,
+      FloatPointArray& wireLengthGrads,
+      FloatPointArray& densityGrads );
 
   void updateWireLengthCoef(float overflow);
 
   void updateInitialPrevSLPCoordi();
 
   float getStepLength(
-      std::vector<FloatPoint>& prevCoordi_,
-      std::vector<FloatPoint>& prevSumGrads_,
-      std::vector<FloatPoint>& curCoordi_,
-      std::vector<FloatPoint>& curSumGrads_ );
+      FloatPointArray& prevCoordi_,
+      FloatPointArray& prevSumGrads_,
+      FloatPointArray& curCoordi_,
+      FloatPointArray& curSumGrads_ );
 
   void updateNextIter();
   float getPhiCoef(float scaledDiffHpwl);
 
   void updateDb();
 
+  // heap bytes of the optimizer vectors
+  int64_t memoryBytes() const;
+
 private:
   std::shared_ptr<PlacerBase> pb_;
   std::shared_ptr<NesterovBase> nb_;
@@ -73,29 +92,36 @@ private:
   // SLP is Step Length Prediction.
   //
   // y_st, y_dst, y_wdst, w_pdst
-  std::vector<FloatPoint> curSLPCoordi_;
-  std::vector<FloatPoint> curSLPWireLengthGrads_;
-  std::vector<FloatPoint> curSLPDensityGrads_;
-  std::vector<FloatPoint> curSLPSumGrads_;
+  FloatPointArray curSLPCoordi_;
+  FloatPointArray curSLPWireLengthGrads_;
+  FloatPointArray curSLPDensityGrads_;
+  FloatPointArray curSLPSumGrads_;
 
   // y0_st, y0_dst, y0_wdst, y0_pdst
-  std::vector<FloatPoint> nextSLPCoordi_;
-  std::vector<FloatPoint> nextSLPWireLengthGrads_;
-  std::vector<FloatPoint> nextSLPDensityGrads_;
-  std::vector<FloatPoint> nextSLPSumGrads_;
+  FloatPointArray nextSLPCoordi_;
+  FloatPointArray nextSLPWireLengthGrads_;
+  FloatPointArray nextSLPDensityGrads_;
+  FloatPointArray nextSLPSumGrads_;
 
   // z_st, z_dst, z_wdst, z_pdst
-  std::vector<FloatPoint> prevSLPCoordi_;
-  std::vector<FloatPoint> prevSLPWireLengthGrads_;
-  std::vector<FloatPoint> prevSLPDensityGrads_;
-  std::vector<FloatPoint> prevSLPSumGrads_;
+  FloatPointArray prevSLPCoordi_;
+  FloatPointArray prevSLPWireLengthGrads_;
+  FloatPointArray prevSLPDensityGrads_;
+  FloatPointArray prevSLPSumGrads_;
 
   // x_st and x0_st
-  std::vector<FloatPoint> curCoordi_;
-  std::vector<FloatPoint> nextCoordi_;
+  FloatPointArray curCoordi_;
+  FloatPointArray nextCoordi_;
+
+  // static preconditioners of each gCell.
+  // they only depend on pin counts and cell areas.
+  FloatPointArray wireLengthPrecondi_;
+  FloatPointArray densityPrecondi_;
 
   float wireLengthGradSum_;
   float densityGradSum_;
+  // second norm of the last sumGrads of updateGradients
+  float sumGradNorm_;
 
   // alpha
   float stepLength_;
@@ -122,6 +148,9 @@ private:
   float getWireLengthCoef(float overflow);
 
   void init();
+  void initPreconditioners();
+  void splitFillerGCells();
+  void reorderForLocality();
   void reset();
 
 };
@@ -0,0 +1,22 @@
+#ifndef __REPLACE_PARALLEL__
+#define __REPLACE_PARALLEL__
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace replace {
+
+// OpenMP threads of the next parallel region; 1 without OpenMP.
+inline int
+getMaxThreads() {
+#ifdef _OPENMP
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
+}
+
+#endif
@@ -3,7 +3,10 @@
 #include "logger.h"
 
 #include <opendb/db.h>
+#include <opendb/dbTransform.h>
 #include <iostream>
+#include <algorithm>
+#include <chrono>
 
 namespace replace {
 
@@ -27,25 +30,43 @@ std::shared_ptr<Logger> slog_;
 static bool
 isCoreAreaOverlap(Die& die, Instance& inst);
 
+static bool
+isSignalNet(odb::dbNet* net);
+
+template <class T>
+static void
+setIdMap(std::vector<T*>& idMap, unsigned id, T* obj);
+
+template <class T>
+static T*
+getIdMap(const std::vector<T*>& idMap, unsigned id);
+
+template <class T, class Rebase>
+static void
+growStor(std::vector<T>& stor, Rebase rebase);
+
+template <class T>
+static void
+rebasePtrs(std::vector<T*>& ptrs, const T* oldBegin, T* newBegin);
+
 static int64_t
 getOverlapWithCoreArea(Die& die, Instance& inst);
 
+static odb::Point
+getMTermOffset(odb::dbMTerm* mTerm);
+
 
 ////////////////////////////////////////////////////////
 // Instance 
 
 Instance::Instance() : inst_(nullptr), 
-  lx_(0), ly_(0), ux_(0), uy_(0), extId_(INT_MIN) {}
+  lx_(0), ly_(0), ux_(0), uy_(0), extId_(INT_MIN),
+  dbLessInstField_(0), dbLessFixedField_(0), removedField_(0) {}
 
 // for movable real instances
 Instance::Instance(odb::dbInst* inst) : Instance() {
   inst_ = inst;
-  int lx = 0, ly = 0;
-  inst_->getLocation(lx, ly);
-  lx_ = lx; 
-  ly_ = ly;
-  ux_ = lx + inst_->getBBox()->getDX();
-  uy_ = ly + inst_->getBBox()->getDY();
+  updateCoordi();
 
   // 
   // TODO
@@ -64,14 +85,14 @@ Instance::Instance(int lx, int ly, int ux, int uy)
   uy_ = uy;
 }
 
-
-Instance::~Instance() { 
-  inst_ = nullptr;
-  lx_ = ly_ = 0;
-  ux_ = uy_ = 0;
-  pins_.clear();
+// for db-less real instances
+Instance::Instance(int lx, int ly, int ux, int uy, bool isFixed)
+  : Instance(lx, ly, ux, uy) {
+  dbLessInstField_ = 1;
+  dbLessFixedField_ = (isFixed)? 1 : 0;
 }
 
+
 bool 
 Instance::isFixed() const {
   // dummy instance is always fixed
@@ -79,6 +100,10 @@ Instance::isFixed() const {
     return true;
   }
 
+  if( !inst_ ) {
+    return (dbLessFixedField_ == 1);
+  }
+
   switch( inst_->getPlacementStatus() ) {
     case dbPlacementStatus::NONE:
     case dbPlacementStatus::UNPLACED:
@@ -97,7 +122,7 @@ Instance::isFixed() const {
 
 bool
 Instance::isInstance() const {
-  return (inst_ != nullptr);
+  return (inst_ != nullptr || dbLessInstField_ == 1);
 }
 
 bool
@@ -107,7 +132,18 @@ Instance::isPlaceInstance() const {
 
 bool
 Instance::isDummy() const {
-  return (inst_ == nullptr);
+  return !isInstance() && !isRemoved();
+}
+
+bool
+Instance::isRemoved() const {
+  return (removedField_ == 1);
+}
+
+void
+Instance::setRemoved() {
+  *this = Instance();
+  removedField_ = 1;
 }
 
 void
@@ -141,16 +177,26 @@ Instance::setCenterLocation(int x, int y) {
 
 void
 Instance::dbSetPlaced() {
+  if( !inst_ ) {
+    return;
+  }
   inst_->setPlacementStatus(dbPlacementStatus::PLACED);
 }
 
 void
 Instance::dbSetPlacementStatus(dbPlacementStatus ps) {
+  if( !inst_ ) {
+    return;
+  }
   inst_->setPlacementStatus(ps);
 }
 
 void
 Instance::dbSetLocation() {
+  // db-less instance only keeps its own location
+  if( !inst_ ) {
+    return;
+  }
   inst_->setLocation(lx_, ly_);
 }
 
@@ -208,8 +254,8 @@ Instance::dy() const {
 }
 
 void
-Instance::addPin(Pin* pin) {
-  pins_.push_back(pin);
+Instance::setPins(PointerRange<Pin> pins) {
+  pins_ = pins;
 }
 
 void
@@ -217,6 +263,16 @@ Instance::setExtId(int extId) {
   extId_ = extId;
 }
 
+void
+Instance::updateCoordi() {
+  int lx = 0, ly = 0;
+  inst_->getLocation(lx, ly);
+  lx_ = lx; 
+  ly_ = ly;
+  ux_ = lx + inst_->getBBox()->getDX();
+  uy_ = ly + inst_->getBBox()->getDY();
+}
+
 ////////////////////////////////////////////////////////
 // Pin 
 
@@ -226,7 +282,8 @@ Pin::Pin()
     offsetCx_(0), offsetCy_(0),
     iTermField_(0), bTermField_(0),
     minPinXField_(0), minPinYField_(0),
-    maxPinXField_(0), maxPinYField_(0) {}
+    maxPinXField_(0), maxPinYField_(0),
+    removedField_(0) {}
 
 Pin::Pin(odb::dbITerm* iTerm): Pin() {
   setITerm();
@@ -234,6 +291,12 @@ Pin::Pin(odb::dbITerm* iTerm): Pin() {
   updateCoordi(iTerm);
 }
 
+Pin::Pin(odb::dbITerm* iTerm, const odb::Point& mTermOffset): Pin() {
+  setITerm();
+  term_ = (void*)iTerm;
+  updateCoordi(iTerm, mTermOffset);
+}
+
 Pin::Pin(odb::dbBTerm* bTerm): Pin() {
   setBTerm();
   term_ = (void*)bTerm;
@@ -328,51 +391,23 @@ odb::dbBTerm* Pin::dbBTerm() const {
 }
 
 void Pin::updateCoordi(odb::dbITerm* iTerm) {
-  int offsetLx = INT_MAX;
-  int offsetLy = INT_MAX;
-  int offsetUx = INT_MIN;
-  int offsetUy = INT_MIN;
-
-  for(dbMPin* mPin : iTerm->getMTerm()->getMPins()) {
-    for(dbBox* box : mPin->getGeometry()) {
-      offsetLx = std::min(box->xMin(), offsetLx);
-      offsetLy = std::min(box->yMin(), offsetLy);
-      offsetUx = std::max(box->xMax(), offsetUx);
-      offsetUy = std::max(box->yMax(), offsetUy);
-    } 
-  }
-
-  int lx = iTerm->getInst()->getBBox()->xMin();
-  int ly = iTerm->getInst()->getBBox()->yMin();
-    
-  int instCenterX = iTerm->getInst()->getMaster()->getWidth()/2;
-  int instCenterY = iTerm->getInst()->getMaster()->getHeight()/2;
-
-  // Pin SHAPE is NOT FOUND; 
-  // (may happen on OpenDB bug case)
-  if( offsetLx == INT_MAX || offsetLy == INT_MAX || 
-      offsetUx == INT_MIN || offsetUy == INT_MIN ) {
-    
-    // offset is center of instances
-    offsetCx_ = offsetCy_ = 0;
-  }
-  // usual case
-  else {
+  updateCoordi(iTerm, getMTermOffset(iTerm->getMTerm()));
+}
 
+void Pin::updateCoordi(odb::dbITerm* iTerm, 
+    const odb::Point& mTermOffset) {
+  // mTermOffset is on the master's (R0) coordinates.
+  // Rotate/flip it around the center with the instance's orient.
+  odb::Point offset = mTermOffset;
+  odb::dbTransform transform(iTerm->getInst()->getOrient());
+  transform.apply(offset);
 
-    // offset is Pin BBoxs' center, so
-    // subtract the Origin coordinates (e.g. instCenterX, instCenterY)
-    //
-    // Transform coordinates 
-    // from (origin: 0,0) 
-    // to (origin: instCenterX, instCenterY)
-    //
-    offsetCx_ = (offsetLx + offsetUx)/2 - instCenterX;
-    offsetCy_ = (offsetLy + offsetUy)/2 - instCenterY;
-  }
+  offsetCx_ = offset.x();
+  offsetCy_ = offset.y();
 
-  cx_ = lx + instCenterX + offsetCx_;
-  cy_ = ly + instCenterY + offsetCy_;
+  dbBox* instBox = iTerm->getInst()->getBBox();
+  cx_ = (instBox->xMin() + instBox->xMax())/2 + offsetCx_;
+  cy_ = (instBox->yMin() + instBox->yMax())/2 + offsetCy_;
 }
 
 // 
@@ -405,6 +440,18 @@ void Pin::updateCoordi(odb::dbBTerm* bTerm) {
   cy_ = (ly + uy)/2;
 }
 
+void
+Pin::setOffsetCoordi(int offsetCx, int offsetCy) {
+  offsetCx_ = offsetCx;
+  offsetCy_ = offsetCy;
+}
+
+void
+Pin::setCoordi(int cx, int cy) {
+  cx_ = cx;
+  cy_ = cy;
+}
+
 void
 Pin::updateLocation(const Instance* inst) {
   cx_ = inst->cx() + offsetCx_;
@@ -429,26 +476,27 @@ Pin::isPlaceInstConnected() const {
   return inst_->isPlaceInstance();
 }
 
-Pin::~Pin() {
-  term_ = nullptr;
-  inst_ = nullptr;
-  net_ = nullptr;
+bool
+Pin::isRemoved() const {
+  return (removedField_ == 1);
+}
+
+void
+Pin::setRemoved() {
+  *this = Pin();
+  removedField_ = 1;
 }
 
 ////////////////////////////////////////////////////////
 // Net 
 
-Net::Net() : net_(nullptr), lx_(0), ly_(0), ux_(0), uy_(0) {}
+Net::Net() : net_(nullptr), lx_(0), ly_(0), ux_(0), uy_(0),
+  removedField_(0) {}
 Net::Net(odb::dbNet* net) : Net() {
   net_ = net;
   updateBox();
 }
 
-Net::~Net() {
-  net_ = nullptr;
-  lx_ = ly_ = ux_ = uy_ = 0;
-}
-
 int Net::lx() const {
   return lx_;
 }
@@ -482,6 +530,19 @@ void Net::updateBox() {
   ly_ = INT_MAX;
   ux_ = INT_MIN;
   uy_ = INT_MIN;
+
+  // db-less net: instances' bbox and IO pins' location
+  if( !net_ ) {
+    for(auto& pin : pins_) {
+      Instance* inst = pin->instance();
+      lx_ = std::min((inst)? inst->lx() : pin->cx(), lx_);
+      ly_ = std::min((inst)? inst->ly() : pin->cy(), ly_);
+      ux_ = std::max((inst)? inst->ux() : pin->cx(), ux_);
+      uy_ = std::max((inst)? inst->uy() : pin->cy(), uy_);
+    }
+    return;
+  }
+
   for(dbITerm* iTerm : net_->getITerms()) {
     dbBox* box = iTerm->getInst()->getBBox();
     lx_ = std::min(box->xMin(), lx_);
@@ -499,14 +560,23 @@ void Net::updateBox() {
   }
 }
 
-void Net::addPin(Pin* pin) {
-  pins_.push_back(pin);
+void Net::setPins(PointerRange<Pin> pins) {
+  pins_ = pins;
 }
 
 odb::dbSigType Net::getSigType() const { 
   return net_->getSigType();
 }
 
+bool Net::isRemoved() const {
+  return (removedField_ == 1);
+}
+
+void Net::setRemoved() {
+  *this = Net();
+  removedField_ = 1;
+}
+
 ////////////////////////////////////////////////////////
 // Die 
 
@@ -541,6 +611,22 @@ Die::setCoreBox(odb::Rect* coreRect) {
   coreUy_ = coreRect->yMax();
 }
 
+void
+Die::setDieBox(int lx, int ly, int ux, int uy) {
+  dieLx_ = lx;
+  dieLy_ = ly;
+  dieUx_ = ux;
+  dieUy_ = uy;
+}
+
+void
+Die::setCoreBox(int lx, int ly, int ux, int uy) {
+  coreLx_ = lx;
+  coreLy_ = ly;
+  coreUx_ = ux;
+  coreUy_ = uy;
+}
+
 int
 Die::dieCx() const { 
   return (dieLx_ + dieUx_)/2;
@@ -581,13 +667,134 @@ Die::coreDy() const {
   return coreUy_ - coreLy_;
 }
 
+////////////////////////////////////////////////////////
+// PlacerBaseData
+
+PlacerBaseData::PlacerBaseData()
+  : siteSizeX(0), siteSizeY(0), netCnt(0) {
+  die.lx = die.ly = die.ux = die.uy = 0;
+  core.lx = core.ly = core.ux = core.uy = 0;
+}
+
+////////////////////////////////////////////////////////
+// PlacerBaseCallBack
+
+// Patches PlacerBase on dbBlock netlist changes between 
+// global_placement calls (See PlacerBase::sync).
+// dbInst/dbNet destroys also remove their remaining pins,
+// so it doesn't depend on whether their terms are 
+// disconnected one by one before.
+class PlacerBaseCallBack : public odb::dbBlockCallBackObj {
+public:
+  PlacerBaseCallBack(PlacerBase* pb);
+
+  void inDbInstCreate(dbInst* inst) override;
+  void inDbInstDestroy(dbInst* inst) override;
+  void inDbInstSwapMasterAfter(dbInst* inst) override;
+  void inDbNetCreate(dbNet* net) override;
+  void inDbNetDestroy(dbNet* net) override;
+  void inDbITermPostConnect(dbITerm* iTerm) override;
+  void inDbITermPreDisconnect(dbITerm* iTerm) override;
+  void inDbBTermCreate(dbBTerm* bTerm) override;
+  void inDbBTermDestroy(dbBTerm* bTerm) override;
+  void inDbBTermPostConnect(dbBTerm* bTerm) override;
+  void inDbBTermPreDisconnect(dbBTerm* bTerm) override;
+
+  // events since the last clear()
+  int netlistChangeCnt() const { return netlistChangeCnt_; }
+  int swapMasterCnt() const { return swapMasterCnt_; }
+  void clear();
+
+private:
+  PlacerBase* pb_;
+  int netlistChangeCnt_;
+  int swapMasterCnt_;
+};
+
+PlacerBaseCallBack::PlacerBaseCallBack(PlacerBase* pb)
+  : pb_(pb), netlistChangeCnt_(0), swapMasterCnt_(0) {}
+
+void
+PlacerBaseCallBack::inDbInstCreate(dbInst* inst) {
+  pb_->addInstance(inst);
+  netlistChangeCnt_++;
+}
+
+void
+PlacerBaseCallBack::inDbInstDestroy(dbInst* inst) {
+  pb_->removeInstance(inst);
+  netlistChangeCnt_++;
+}
+
+// iTerms are kept on swapMaster, 
+// so only instance size and pin offsets are changed.
+void
+PlacerBaseCallBack::inDbInstSwapMasterAfter(dbInst*) {
+  swapMasterCnt_++;
+}
+
+void
+PlacerBaseCallBack::inDbNetCreate(dbNet* net) {
+  pb_->addNet(net);
+  netlistChangeCnt_++;
+}
+
+void
+PlacerBaseCallBack::inDbNetDestroy(dbNet* net) {
+  pb_->removeNet(net);
+  netlistChangeCnt_++;
+}
+
+void
+PlacerBaseCallBack::inDbITermPostConnect(dbITerm* iTerm) {
+  pb_->addPin(iTerm);
+  netlistChangeCnt_++;
+}
+
+void
+PlacerBaseCallBack::inDbITermPreDisconnect(dbITerm* iTerm) {
+  pb_->removePin(iTerm);
+  netlistChangeCnt_++;
+}
+
+// bTerms are created on their nets
+void
+PlacerBaseCallBack::inDbBTermCreate(dbBTerm* bTerm) {
+  pb_->addPin(bTerm);
+  netlistChangeCnt_++;
+}
+
+void
+PlacerBaseCallBack::inDbBTermDestroy(dbBTerm* bTerm) {
+  pb_->removePin(bTerm);
+  netlistChangeCnt_++;
+}
+
+void
+PlacerBaseCallBack::inDbBTermPostConnect(dbBTerm* bTerm) {
+  pb_->addPin(bTerm);
+  netlistChangeCnt_++;
+}
+
+void
+PlacerBaseCallBack::inDbBTermPreDisconnect(dbBTerm* bTerm) {
+  pb_->removePin(bTerm);
+  netlistChangeCnt_++;
+}
+
+void
+PlacerBaseCallBack::clear() {
+  netlistChangeCnt_ = 0;
+  swapMasterCnt_ = 0;
+}
+
 ////////////////////////////////////////////////////////
 // PlacerBase
 
 PlacerBase::PlacerBase() 
   : db_(nullptr), log_(nullptr), siteSizeX_(0), siteSizeY_(0),
   placeInstsArea_(0), nonPlaceInstsArea_(0),
-  macroInstsArea_(0), stdInstsArea_(0) {}
+  macroInstsArea_(0), stdInstsArea_(0), block_(nullptr) {}
 
 PlacerBase::PlacerBase(odb::dbDatabase* db,
     std::shared_ptr<Logger> log)
@@ -597,6 +804,13 @@ PlacerBase::PlacerBase(odb::dbDatabase* db,
   init();
 }
 
+PlacerBase::PlacerBase(const PlacerBaseData& data,
+    std::shared_ptr<Logger> log)
+  : PlacerBase() {
+  log_ = log;
+  init(data);
+}
+
 PlacerBase::~PlacerBase() {
   reset();
 }
@@ -605,6 +819,8 @@ PlacerBase::~PlacerBase() {
 void 
 PlacerBase::init() {
   slog_ = log_;
+  ProfileScope scope(log_, "PlacerBaseInit");
+  auto startTime = std::chrono::steady_clock::now();
 
   log_->infoInt("DBU", db_->getTech()->getDbUnitsPerMicron()); 
 
@@ -616,6 +832,16 @@ PlacerBase::init() {
   odb::Rect coreRect = getCoreRectFromDb(rows);
   die_ = Die(block->getBBox(), &coreRect);
  
+  // rows' bbox update
+  rows_.reserve(rows.size());
+  for(dbRow* row : rows) {
+    Rect rect;
+    row->getBBox(rect);
+    PlacerBaseData::Box box = {rect.xMin(), rect.yMin(), 
+      rect.xMax(), rect.yMax()};
+    rows_.push_back(box);
+  }
+ 
   // siteSize update 
   dbRow* firstRow = *(rows.begin());
   siteSizeX_ = firstRow->getSite()->getWidth();
@@ -636,59 +862,37 @@ PlacerBase::init() {
   initInstsForFragmentedRow();
 
 
-  // init inst ptrs and areas
+  // init inst ptrs
   insts_.reserve(instStor_.size());
+  instIdMap_.reserve(insts.size() + 1);
   for(auto& inst : instStor_) {
     if(inst.isInstance()) {
-      if(inst.isFixed()) {
-        // Check whether fixed instance is 
-        // within the corearea
-        //
-        // outside of corearea is none of RePlAce's business
-        if( isCoreAreaOverlap( die_, inst ) ) {
-          fixedInsts_.push_back(&inst); 
-          nonPlaceInsts_.push_back(&inst);
-          nonPlaceInstsArea_ += 
-            getOverlapWithCoreArea( die_, inst );
-        }
-      }
-      else {
-        placeInsts_.push_back(&inst);
-        int64_t instArea = static_cast<int64_t>(inst.dx())
-          * static_cast<int64_t>(inst.dy());
-        placeInstsArea_ += instArea; 
-        // macro cells should be
-        // macroInstsArea_
-        if( inst.dy() > siteSizeY_ * 6 ) {
-          macroInstsArea_ += instArea;
-        }
-        // smaller or equal height cells should be 
-        // stdInstArea_
-        else {
-          stdInstsArea_ += instArea;
-        }
-      }
-      instMap_[inst.dbInst()] = &inst;
-    }
-    else if(inst.isDummy()) {
-      dummyInsts_.push_back(&inst);
-      nonPlaceInsts_.push_back(&inst);
-      nonPlaceInstsArea_ += static_cast<int64_t>(inst.dx()) 
-        * static_cast<int64_t>(inst.dy());
+      setIdMap(instIdMap_, inst.dbInst()->getId(), &inst);
     }
     insts_.push_back(&inst);
   }
 
+  // init inst categories and areas
+  initInstsCategory();
+
   // nets fill
   dbSet<dbNet> nets = block->getNets();
-  netStor_.reserve(nets.size());
+
+  // count pins first, so pinStor_ is allocated once
+  int pinCnt = 0;
   for(dbNet* net : nets) {
-    dbSigType netType = net->getSigType();
+    if( !isSignalNet(net) ) {
+      continue;
+    }
+    pinCnt += net->getITerms().size() + net->getBTerms().size();
+  }
+  pinStor_.reserve(pinCnt);
 
+  netStor_.reserve(nets.size());
+  netIdMap_.reserve(nets.size() + 1);
+  for(dbNet* net : nets) {
     // escape nets with VDD/VSS/reset nets
-    if( netType == dbSigType::GROUND ||
-        netType == dbSigType::POWER ||
-        netType == dbSigType::RESET ) {
+    if( !isSignalNet(net) ) {
       continue;
     }
 
@@ -697,10 +901,10 @@ PlacerBase::init() {
     
     // this is safe because of "reserve"
     Net* myNetPtr = &netStor_[netStor_.size()-1];
-    netMap_[net] = myNetPtr;
+    setIdMap(netIdMap_, net->getId(), myNetPtr);
 
     for(dbITerm* iTerm : net->getITerms()) {
-      Pin myPin(iTerm);
+      Pin myPin(iTerm, mTermOffset(iTerm->getMTerm()));
       myPin.setNet(myNetPtr); 
       myPin.setInstance( dbToPlace(iTerm->getInst()) );
       pinStor_.push_back( myPin );
@@ -713,140 +917,741 @@ PlacerBase::init() {
     }
   }
 
-  // pinMap_ and pins_ update
+  // iTermIdMap_/bTermIdMap_ and pins_ update
   pins_.reserve(pinStor_.size());
+  iTermIdMap_.reserve(pinStor_.size() + 1);
   for(auto& pin : pinStor_) {
     if( pin.isITerm() ) {
-      pinMap_[(void*)pin.dbITerm()] = &pin;
+      setIdMap(iTermIdMap_, pin.dbITerm()->getId(), &pin);
     }
     else if( pin.isBTerm() ) {
-      pinMap_[(void*)pin.dbBTerm()] = &pin;
+      setIdMap(bTermIdMap_, pin.dbBTerm()->getId(), &pin);
+    }
+    pins_.push_back(&pin);
+  }
+
+  // instStor_'s/netStor_'s pins fill
+  initPinLists();
+
+  nets_.reserve(netStor_.size());
+  for(auto& net : netStor_) {
+    nets_.push_back(&net);
+  }
+
+  // subscribe dbBlock changes for sync()
+  callBack_.reset(new PlacerBaseCallBack(this));
+  callBack_->addOwner(block);
+  block_ = block;
+
+  log_->infoRuntime("PlacerBaseInit", 
+      std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime).count(), 1);
+
+  printInfo();
+}
+
+// db-less init. 
+// Pins and nets are filled in the order of data.pins
+void
+PlacerBase::init(const PlacerBaseData& data) {
+  slog_ = log_;
+  ProfileScope scope(log_, "PlacerBaseInit");
+  auto startTime = std::chrono::steady_clock::now();
+
+  die_.setDieBox(data.die.lx, data.die.ly, data.die.ux, data.die.uy);
+  die_.setCoreBox(data.core.lx, data.core.ly, data.core.ux, data.core.uy);
+  siteSizeX_ = data.siteSizeX;
+  siteSizeY_ = data.siteSizeY;
+  rows_ = data.rows;
+
+  log_->infoIntPair("SiteSize", siteSizeX_, siteSizeY_);
+  log_->infoIntPair("CoreAreaLxLy", die_.coreLx(), die_.coreLy());
+  log_->infoIntPair("CoreAreaUxUy", die_.coreUx(), die_.coreUy());
+
+  // insts fill with real instances
+  instStor_.reserve(data.insts.size());
+  for(auto& instData : data.insts) {
+    Instance myInst(instData.box.lx, instData.box.ly,
+        instData.box.ux, instData.box.uy, instData.isFixed);
+    instStor_.push_back( myInst );
+  }
+
+  // insts fill with fake instances (fragmented row)
+  initInstsForFragmentedRow();
+
+  insts_.reserve(instStor_.size());
+  for(auto& inst : instStor_) {
+    insts_.push_back(&inst);
+  }
+  initInstsCategory();
+
+  // nets/pins fill
+  netStor_.resize(data.netCnt);
+  pinStor_.reserve(data.pins.size());
+  for(auto& pinData : data.pins) {
+    Pin myPin;
+    myPin.setNet(&netStor_[pinData.net]);
+    if( pinData.inst >= 0 ) {
+      myPin.setITerm();
+      myPin.setInstance(&instStor_[pinData.inst]);
+      myPin.setOffsetCoordi(pinData.x, pinData.y);
+      myPin.updateLocation(&instStor_[pinData.inst]);
     }
+    else {
+      myPin.setBTerm();
+      myPin.setCoordi(pinData.x, pinData.y);
+    }
+    pinStor_.push_back( myPin );
+  }
+
+  pins_.reserve(pinStor_.size());
+  for(auto& pin : pinStor_) {
     pins_.push_back(&pin);
   }
+  initPinLists();
+
+  nets_.reserve(netStor_.size());
+  for(auto& net : netStor_) {
+    nets_.push_back(&net);
+  }
+
+  log_->infoRuntime("PlacerBaseInit", 
+      std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime).count(), 1);
+
+  printInfo();
+}
+
+PlacerBaseData
+PlacerBase::toData() const {
+  PlacerBaseData data;
+  data.die.lx = die_.dieLx();
+  data.die.ly = die_.dieLy();
+  data.die.ux = die_.dieUx();
+  data.die.uy = die_.dieUy();
+  data.core.lx = die_.coreLx();
+  data.core.ly = die_.coreLy();
+  data.core.ux = die_.coreUx();
+  data.core.uy = die_.coreUy();
+  data.siteSizeX = siteSizeX_;
+  data.siteSizeY = siteSizeY_;
+  data.rows = rows_;
+
+  // data indices of instStor_/netStor_, 
+  // which have holes after the netlist patches.
+  std::vector<int> instDataIdx(instStor_.size(), -1);
+  for(auto& inst : insts_) {
+    if( !inst->isInstance() ) {
+      continue;
+    }
+    instDataIdx[instIndex(inst)] = data.insts.size();
+    PlacerBaseData::InstData instData;
+    instData.box.lx = inst->lx();
+    instData.box.ly = inst->ly();
+    instData.box.ux = inst->ux();
+    instData.box.uy = inst->uy();
+    instData.isFixed = inst->isFixed();
+    data.insts.push_back(instData);
+  }
+
+  std::vector<int> netDataIdx(netStor_.size(), -1);
+  for(size_t i=0; i<nets_.size(); i++) {
+    netDataIdx[netIndex(nets_[i])] = i;
+  }
+
+  data.pins.reserve(pins_.size());
+  for(auto& pin : pins_) {
+    PlacerBaseData::PinData pinData;
+    pinData.net = netDataIdx[netIndex(pin->net())];
+    if( pin->instance() ) {
+      pinData.inst = instDataIdx[instIndex(pin->instance())];
+      pinData.x = pin->offsetCx();
+      pinData.y = pin->offsetCy();
+    }
+    else {
+      pinData.inst = -1;
+      pinData.x = pin->cx();
+      pinData.y = pin->cy();
+    }
+    data.pins.push_back(pinData);
+  }
+  data.netCnt = nets_.size();
+  return data;
+}
+
+// Count-then-fill of instances' and nets' pin lists.
+// Each list is a range of instPinStor_/netPinStor_,
+// so the lists take two allocations in total.
+// Removed objects get empty lists.
+//
+// nets' pins are in pinStor_ order, i.e. ITerms then BTerms.
+// OpenDB instances' pins are in their ITerms' order 
+// (VDD/VSS ITerms have no pins), and db-less instances' pins
+// are in pinStor_ order.
+void
+PlacerBase::initPinLists() {
+  std::vector<int> instPinCnts(instStor_.size(), 0);
+  std::vector<int> netPinCnts(netStor_.size(), 0);
+  for(auto& pin : pinStor_) {
+    if( pin.isRemoved() ) {
+      continue;
+    }
+    if( pin.instance() ) {
+      instPinCnts[instIndex(pin.instance())]++;
+    }
+    netPinCnts[netIndex(pin.net())]++;
+  }
+
+  // instPinCnts/netPinCnts become the fill cursors
+  std::vector<int> instPinBegins(instStor_.size(), 0);
+  int pinCnt = 0;
+  for(size_t i=0; i<instStor_.size(); i++) {
+    instPinBegins[i] = pinCnt;
+    pinCnt += instPinCnts[i];
+    instPinCnts[i] = instPinBegins[i];
+  }
+  instPinStor_.assign(pinCnt, nullptr);
+
+  std::vector<int> netPinBegins(netStor_.size(), 0);
+  pinCnt = 0;
+  for(size_t i=0; i<netStor_.size(); i++) {
+    netPinBegins[i] = pinCnt;
+    pinCnt += netPinCnts[i];
+    netPinCnts[i] = netPinBegins[i];
+  }
+  netPinStor_.assign(pinCnt, nullptr);
+
+  for(auto& pin : pinStor_) {
+    if( pin.isRemoved() ) {
+      continue;
+    }
+    Instance* inst = pin.instance();
+    if( inst && !inst->dbInst() ) {
+      instPinStor_[instPinCnts[instIndex(inst)]++] = &pin;
+    }
+    netPinStor_[netPinCnts[netIndex(pin.net())]++] = &pin;
+  }
 
-  // instStor_'s pins_ fill
-  for(auto& inst : instStor_ ) {
-    if( !inst.isInstance() ) {
+  for(auto& inst : instStor_) {
+    if( !inst.dbInst() ) {
       continue;
     }
+    int& cursor = instPinCnts[instIndex(&inst)];
     for(dbITerm* iTerm : inst.dbInst()->getITerms()) {
-      // note that, DB's ITerm can have
-      // VDD/VSS pins.
-      //
-      // Escape those pins
-      Pin* curPin = dbToPlace(iTerm);
-      if( curPin ) {
-        inst.addPin( curPin );
+      Pin* pin = dbToPlace(iTerm);
+      if( pin ) {
+        instPinStor_[cursor++] = pin;
       }
     }
   }
 
-  // nets' pin update
-  nets_.reserve(netStor_.size());
+  for(size_t i=0; i<instStor_.size(); i++) {
+    instStor_[i].setPins( PointerRange<Pin>(
+          instPinStor_.data() + instPinBegins[i], 
+          instPinCnts[i] - instPinBegins[i]) );
+  }
+  for(size_t i=0; i<netStor_.size(); i++) {
+    netStor_[i].setPins( PointerRange<Pin>(
+          netPinStor_.data() + netPinBegins[i], 
+          netPinCnts[i] - netPinBegins[i]) );
+  }
+}
+
+// fill placeInsts_, fixedInsts_, dummyInsts_, nonPlaceInsts_
+// and their areas from insts_.
+void
+PlacerBase::initInstsCategory() {
+  placeInsts_.clear();
+  fixedInsts_.clear();
+  dummyInsts_.clear();
+  nonPlaceInsts_.clear();
+  placeInstsArea_ = nonPlaceInstsArea_ = 0;
+  macroInstsArea_ = stdInstsArea_ = 0;
+
+  for(auto& inst : insts_) {
+    if(inst->isInstance()) {
+      if(inst->isFixed()) {
+        // Check whether fixed instance is 
+        // within the corearea
+        //
+        // outside of corearea is none of RePlAce's business
+        if( isCoreAreaOverlap( die_, *inst ) ) {
+          fixedInsts_.push_back(inst); 
+          nonPlaceInsts_.push_back(inst);
+          nonPlaceInstsArea_ += 
+            getOverlapWithCoreArea( die_, *inst );
+        }
+      }
+      else {
+        placeInsts_.push_back(inst);
+        int64_t instArea = static_cast<int64_t>(inst->dx())
+          * static_cast<int64_t>(inst->dy());
+        placeInstsArea_ += instArea; 
+        // macro cells should be
+        // macroInstsArea_
+        if( inst->dy() > siteSizeY_ * 6 ) {
+          macroInstsArea_ += instArea;
+        }
+        // smaller or equal height cells should be 
+        // stdInstArea_
+        else {
+          stdInstsArea_ += instArea;
+        }
+      }
+    }
+    else if(inst->isDummy()) {
+      dummyInsts_.push_back(inst);
+      nonPlaceInsts_.push_back(inst);
+      nonPlaceInstsArea_ += static_cast<int64_t>(inst->dx()) 
+        * static_cast<int64_t>(inst->dy());
+    }
+  }
+}
+
+// pin offsets are same on all instances of a master,
+// so cache them per dbMTerm. 
+// All mTerms of a master are filled on its first lookup.
+// (dbMaster ids are unique within a dbLib)
+odb::Point
+PlacerBase::mTermOffset(odb::dbMTerm* mTerm) {
+  dbMaster* master = mTerm->getMaster();
+  const unsigned libId = master->getLib()->getId();
+  if( masterOffsetBegins_.size() <= libId ) {
+    masterOffsetBegins_.resize(libId + 1);
+  }
+  std::vector<int>& offsetBegins = masterOffsetBegins_[libId];
+  const unsigned masterId = master->getId();
+  if( offsetBegins.size() <= masterId ) {
+    offsetBegins.resize(masterId + 1, -1);
+  }
+
+  if( offsetBegins[masterId] == -1 ) {
+    const int begin = mTermOffsets_.size();
+    offsetBegins[masterId] = begin;
+    mTermOffsets_.resize(begin + master->getMTermCount());
+    for(dbMTerm* term : master->getMTerms()) {
+      odb::Point offset = getMTermOffset(term);
+      mTermOffsets_[begin + term->getIndex()] 
+        = std::make_pair(offset.x(), offset.y());
+    }
+  }
+
+  const std::pair<int, int>& offset 
+    = mTermOffsets_[offsetBegins[masterId] + mTerm->getIndex()];
+  return odb::Point(offset.first, offset.second);
+}
+
+void
+PlacerBase::setLogger(std::shared_ptr<Logger> log) {
+  log_ = log;
+  slog_ = log;
+}
+
+bool
+PlacerBase::isSynced() const {
+  return !callBack_ || ( callBack_->netlistChangeCnt() == 0 
+      && callBack_->swapMasterCnt() == 0 );
+}
+
+bool
+PlacerBase::sync() {
+  if( !callBack_ ) {
+    return false;
+  }
+
+  // The block may be replaced (e.g. read_def on a new chip)
+  // or destroyed, which removes the callback's owner.
+  dbChip* chip = db_->getChip();
+  if( !callBack_->hasOwner() || !chip || chip->getBlock() != block_ ) {
+    return false;
+  }
+
+  ProfileScope scope(log_, "PlacerBaseSync");
+  auto startTime = std::chrono::steady_clock::now();
+
+  // rows must be same, because dummy instances are from rows.
+  dbSet<dbRow> rows = block_->getRows();
+  odb::Rect coreRect = getCoreRectFromDb(rows);
+  if( coreRect.xMin() != die_.coreLx() || coreRect.yMin() != die_.coreLy() ||
+      coreRect.xMax() != die_.coreUx() || coreRect.yMax() != die_.coreUy() ) {
+    return false;
+  }
+
+  // fixed instances must be same, 
+  // because dummy instances are from fixed instances.
+  std::vector<Instance*> prevFixedInsts = fixedInsts_;
+  std::vector<int> prevFixedCoordis;
+  prevFixedCoordis.reserve(4 * fixedInsts_.size());
+  for(auto& inst : fixedInsts_) {
+    prevFixedCoordis.push_back(inst->lx());
+    prevFixedCoordis.push_back(inst->ly());
+    prevFixedCoordis.push_back(inst->ux());
+    prevFixedCoordis.push_back(inst->uy());
+  }
+
+  // lists of the patched storages, in storage order
+  insts_.clear();
+  for(auto& inst : instStor_) {
+    if( !inst.isRemoved() ) {
+      insts_.push_back(&inst);
+    }
+  }
+  pins_.clear();
+  for(auto& pin : pinStor_) {
+    if( !pin.isRemoved() ) {
+      pins_.push_back(&pin);
+    }
+  }
+  nets_.clear();
   for(auto& net : netStor_) {
-    for(dbITerm* iTerm : net.dbNet()->getITerms()) {
-      net.addPin( dbToPlace( iTerm ) );
+    if( !net.isRemoved() ) {
+      nets_.push_back(&net);
     }
-    for(dbBTerm* bTerm : net.dbNet()->getBTerms()) {
-      net.addPin( dbToPlace( bTerm ) );
+  }
+
+  // location, size (swapped master) and placement status update
+  for(auto& inst : insts_) {
+    if( inst->isInstance() ) {
+      inst->updateCoordi();
+    }
+  }
+  initInstsCategory();
+
+  if( fixedInsts_ != prevFixedInsts ) {
+    return false;
+  }
+  for(size_t i=0; i<fixedInsts_.size(); i++) {
+    if( fixedInsts_[i]->lx() != prevFixedCoordis[4*i] ||
+        fixedInsts_[i]->ly() != prevFixedCoordis[4*i+1] ||
+        fixedInsts_[i]->ux() != prevFixedCoordis[4*i+2] ||
+        fixedInsts_[i]->uy() != prevFixedCoordis[4*i+3] ) {
+      return false;
     }
-    nets_.push_back(&net);
   }
 
+  // pins' location and offset (swapped master / orient) update
+  for(auto& pin : pins_) {
+    if( pin->isITerm() ) {
+      pin->updateCoordi(pin->dbITerm(), 
+          mTermOffset(pin->dbITerm()->getMTerm()));
+    }
+    else if( pin->isBTerm() ) {
+      pin->updateCoordi(pin->dbBTerm());
+    }
+  }
+
+  initPinLists();
+
+  // removed slots are reused from now on, lowest first.
+  // Until here they may still be referenced by the lists.
+  freeInstSlots_.clear();
+  for(int i=instStor_.size()-1; i>=0; i--) {
+    if( instStor_[i].isRemoved() ) {
+      freeInstSlots_.push_back(i);
+    }
+  }
+  freePinSlots_.clear();
+  for(int i=pinStor_.size()-1; i>=0; i--) {
+    if( pinStor_[i].isRemoved() ) {
+      freePinSlots_.push_back(i);
+    }
+  }
+  freeNetSlots_.clear();
+  for(int i=netStor_.size()-1; i>=0; i--) {
+    if( netStor_[i].isRemoved() ) {
+      freeNetSlots_.push_back(i);
+    }
+  }
+
+  log_->infoInt("SyncNetlistChanges", callBack_->netlistChangeCnt(), 1);
+  log_->infoInt("SyncSwapMasterInsts", callBack_->swapMasterCnt(), 1);
+  log_->infoRuntime("PlacerBaseSync", 
+      std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - startTime).count(), 1);
+  callBack_->clear();
+
   printInfo();
+  return true;
+}
+
+void
+PlacerBase::addInstance(odb::dbInst* inst) {
+  if( dbToPlace(inst) ) {
+    return;
+  }
+  Instance* myInst = newInstanceSlot();
+  *myInst = Instance(inst);
+  setIdMap(instIdMap_, inst->getId(), myInst);
+}
+
+void
+PlacerBase::removeInstance(odb::dbInst* inst) {
+  Instance* myInst = dbToPlace(inst);
+  if( !myInst ) {
+    return;
+  }
+  for(dbITerm* iTerm : inst->getITerms()) {
+    removePin(iTerm);
+  }
+  myInst->setRemoved();
+  instIdMap_[inst->getId()] = nullptr;
+}
+
+void
+PlacerBase::addNet(odb::dbNet* net) {
+  if( !isSignalNet(net) || dbToPlace(net) ) {
+    return;
+  }
+  Net* myNet = newNetSlot();
+  *myNet = Net(net);
+  setIdMap(netIdMap_, net->getId(), myNet);
+}
+
+void
+PlacerBase::removeNet(odb::dbNet* net) {
+  Net* myNet = dbToPlace(net);
+  if( !myNet ) {
+    return;
+  }
+  for(dbITerm* iTerm : net->getITerms()) {
+    removePin(iTerm);
+  }
+  for(dbBTerm* bTerm : net->getBTerms()) {
+    removePin(bTerm);
+  }
+  myNet->setRemoved();
+  netIdMap_[net->getId()] = nullptr;
+}
+
+// pins are only on signal nets, i.e. nets in netIdMap_
+void
+PlacerBase::addPin(odb::dbITerm* iTerm) {
+  Net* myNet = (iTerm->getNet())? dbToPlace(iTerm->getNet()) : nullptr;
+  if( !myNet || dbToPlace(iTerm) ) {
+    return;
+  }
+  Pin* pin = newPinSlot();
+  *pin = Pin(iTerm, mTermOffset(iTerm->getMTerm()));
+  pin->setNet(myNet);
+  pin->setInstance( dbToPlace(iTerm->getInst()) );
+  setIdMap(iTermIdMap_, iTerm->getId(), pin);
+}
+
+void
+PlacerBase::addPin(odb::dbBTerm* bTerm) {
+  Net* myNet = (bTerm->getNet())? dbToPlace(bTerm->getNet()) : nullptr;
+  if( !myNet || dbToPlace(bTerm) ) {
+    return;
+  }
+  Pin* pin = newPinSlot();
+  *pin = Pin(bTerm);
+  pin->setNet(myNet);
+  setIdMap(bTermIdMap_, bTerm->getId(), pin);
+}
+
+void
+PlacerBase::removePin(odb::dbITerm* iTerm) {
+  Pin* pin = dbToPlace(iTerm);
+  if( !pin ) {
+    return;
+  }
+  pin->setRemoved();
+  iTermIdMap_[iTerm->getId()] = nullptr;
+}
+
+void
+PlacerBase::removePin(odb::dbBTerm* bTerm) {
+  Pin* pin = dbToPlace(bTerm);
+  if( !pin ) {
+    return;
+  }
+  pin->setRemoved();
+  bTermIdMap_[bTerm->getId()] = nullptr;
+}
+
+Instance*
+PlacerBase::newInstanceSlot() {
+  if( !freeInstSlots_.empty() ) {
+    Instance* inst = &instStor_[freeInstSlots_.back()];
+    freeInstSlots_.pop_back();
+    return inst;
+  }
+  growStor(instStor_, 
+      [this](const Instance* oldBegin, Instance* newBegin) {
+      for(auto& pin : pinStor_) {
+        if( pin.instance() ) {
+          pin.setInstance(newBegin + (pin.instance() - oldBegin));
+        }
+      }
+      rebasePtrs(instIdMap_, oldBegin, newBegin);
+      rebasePtrs(insts_, oldBegin, newBegin);
+      rebasePtrs(placeInsts_, oldBegin, newBegin);
+      rebasePtrs(fixedInsts_, oldBegin, newBegin);
+      rebasePtrs(dummyInsts_, oldBegin, newBegin);
+      rebasePtrs(nonPlaceInsts_, oldBegin, newBegin);
+      });
+  instStor_.push_back(Instance());
+  return &instStor_.back();
+}
+
+Pin*
+PlacerBase::newPinSlot() {
+  if( !freePinSlots_.empty() ) {
+    Pin* pin = &pinStor_[freePinSlots_.back()];
+    freePinSlots_.pop_back();
+    return pin;
+  }
+  growStor(pinStor_, 
+      [this](const Pin* oldBegin, Pin* newBegin) {
+      rebasePtrs(iTermIdMap_, oldBegin, newBegin);
+      rebasePtrs(bTermIdMap_, oldBegin, newBegin);
+      rebasePtrs(pins_, oldBegin, newBegin);
+      rebasePtrs(instPinStor_, oldBegin, newBegin);
+      rebasePtrs(netPinStor_, oldBegin, newBegin);
+      });
+  pinStor_.push_back(Pin());
+  return &pinStor_.back();
+}
+
+Net*
+PlacerBase::newNetSlot() {
+  if( !freeNetSlots_.empty() ) {
+    Net* net = &netStor_[freeNetSlots_.back()];
+    freeNetSlots_.pop_back();
+    return net;
+  }
+  growStor(netStor_, 
+      [this](const Net* oldBegin, Net* newBegin) {
+      for(auto& pin : pinStor_) {
+        if( pin.net() ) {
+          pin.setNet(newBegin + (pin.net() - oldBegin));
+        }
+      }
+      rebasePtrs(netIdMap_, oldBegin, newBegin);
+      rebasePtrs(nets_, oldBegin, newBegin);
+      });
+  netStor_.push_back(Net());
+  return &netStor_.back();
 }
 
 void
 PlacerBase::initInstsForFragmentedRow() {
-  dbSet<dbRow> rows = db_->getChip()->getBlock()->getRows();
-  
   // dummy cell update to understand fragmented-row
   //
 
   int siteCountX = (die_.coreUx()-die_.coreLx())/siteSizeX_;
   int siteCountY = (die_.coreUy()-die_.coreLy())/siteSizeY_;
-  
-  enum PlaceInfo {
-    Empty, Row, FixedInst
-  };
- 
-  // 
-  // Initialize siteGrid as empty
+
   //
-  std::vector<PlaceInfo> 
-    siteGrid (
-        siteCountX * siteCountY, 
-        PlaceInfo::Empty);
-  
+  // Occupied rectangles on site-grid indices. 
+  // Rows and fixed instances are not empty.
+  //
+  // Instead of a whole siteCountX * siteCountY grid,
+  // sweep the site rows (j) with the active rectangles and 
+  // find the empty intervals on each site row, so that
+  // memory is proportional to the number of rows and fixed instances.
+  //
+  struct SiteRect {
+    int lx, ly, ux, uy;
+  };
+  std::vector<SiteRect> siteRects;
+  siteRects.reserve(rows_.size());
 
-  // fill in rows' bbox
-  for(dbRow* row : rows) {
-    Rect rect;
-    row->getBBox(rect);
-    
+  auto addSiteRect = [&](int lx, int ly, int ux, int uy) {
     std::pair<int, int> pairX 
-      = getMinMaxIdx(rect.xMin(), rect.xMax(), 
+      = getMinMaxIdx(lx, ux, 
           die_.coreLx(), siteSizeX_, 0, siteCountX);
-
     std::pair<int, int> pairY
-      = getMinMaxIdx(rect.yMin(), rect.yMax(),
+      = getMinMaxIdx(ly, uy,
           die_.coreLy(), siteSizeY_, 0, siteCountY);
 
-    for(int i=pairX.first; i<pairX.second; i++) {
-      for(int j=pairY.first; j<pairY.second; j++) {
-        siteGrid[ j * siteCountX + i ] = Row; 
-      }
+    if( pairX.first < pairX.second && pairY.first < pairY.second ) {
+      SiteRect siteRect = {pairX.first, pairY.first, 
+        pairX.second, pairY.second};
+      siteRects.push_back(siteRect);
     }
+  };
+
+  // rows' bbox
+  for(auto& row : rows_) {
+    addSiteRect(row.lx, row.ly, row.ux, row.uy);
   }
 
-  // fill fixed instances' bbox
+  // fixed instances' bbox
   for(auto& inst: instStor_) {
     if( !inst.isFixed() ) {
       continue;
     }
-    std::pair<int, int> pairX 
-      = getMinMaxIdx(inst.lx(), inst.ux(),
-          die_.coreLx(), siteSizeX_, 0, siteCountX);
-    std::pair<int, int> pairY 
-      = getMinMaxIdx(inst.ly(), inst.uy(),
-          die_.coreLy(), siteSizeY_, 0, siteCountY);
-
-    for(int i=pairX.first; i<pairX.second; i++) {
-      for(int j=pairY.first; j<pairY.second; j++) {
-        siteGrid[ j * siteCountX + i ] = FixedInst; 
-      }
-    }
+    addSiteRect(inst.lx(), inst.ly(), inst.ux(), inst.uy());
   }
 
+  std::sort(siteRects.begin(), siteRects.end(),
+      [](const SiteRect& r1, const SiteRect& r2) {
+      return r1.ly < r2.ly; });
+
   // 
-  // Search the "Empty" coordinates on site-grid
+  // Search the empty intervals on each site row
   // --> These sites need to be dummyInstance
   //
+  std::vector<const SiteRect*> activeRects;
+  std::vector<std::pair<int, int>> intervals;
+  size_t nextRectIdx = 0;
   for(int j=0; j<siteCountY; j++) {
-    for(int i=0; i<siteCountX; i++) {
-      // if empty spot found
-      if( siteGrid[j * siteCountX + i] == Empty ) {
-        int startX = i;
-        // find end points
-        while(i < siteCountX &&
-            siteGrid[j*siteCountX + i] == Empty) {
-          i++;
-        }
-        int endX = i;
+    // drop finished rects and add new rects on j
+    activeRects.erase(
+        std::remove_if(activeRects.begin(), activeRects.end(),
+          [j](const SiteRect* r) { return r->uy <= j; }),
+        activeRects.end());
+    while( nextRectIdx < siteRects.size() 
+        && siteRects[nextRectIdx].ly <= j ) {
+      activeRects.push_back( &siteRects[nextRectIdx++] );
+    }
+
+    intervals.clear();
+    for(auto& r : activeRects) {
+      intervals.push_back( std::make_pair(r->lx, r->ux) );
+    }
+    std::sort(intervals.begin(), intervals.end());
+
+    // gaps between merged intervals are empty
+    int startX = 0;
+    for(auto& interval : intervals) {
+      if( startX < interval.first ) {
         Instance myInst(
             die_.coreLx() + siteSizeX_ * startX,
             die_.coreLy() + siteSizeY_ * j, 
-            die_.coreLx() + siteSizeX_ * endX,
+            die_.coreLx() + siteSizeX_ * interval.first,
             die_.coreLy() + siteSizeY_ * (j+1));
         instStor_.push_back( myInst );
       }
+      startX = std::max(startX, interval.second);
+    }
+
+    if( startX < siteCountX ) {
+      Instance myInst(
+          die_.coreLx() + siteSizeX_ * startX,
+          die_.coreLy() + siteSizeY_ * j, 
+          die_.coreLx() + siteSizeX_ * siteCountX,
+          die_.coreLy() + siteSizeY_ * (j+1));
+      instStor_.push_back( myInst );
     }
   }
 }
 
 void
 PlacerBase::reset() {
+  if( callBack_ && callBack_->hasOwner() ) {
+    callBack_->removeOwner();
+  }
+  callBack_.reset();
+  block_ = nullptr;
+  freeInstSlots_.clear();
+  freePinSlots_.clear();
+  freeNetSlots_.clear();
+  masterOffsetBegins_.clear();
+  mTermOffsets_.clear();
+  rows_.clear();
+
   db_ = nullptr;
   instStor_.clear();
   pinStor_.clear();
@@ -856,52 +1661,103 @@ PlacerBase::reset() {
   nets_.clear();
   insts_.clear();
 
-  instMap_.clear();
-  pinMap_.clear();
-  netMap_.clear();
+  instPinStor_.clear();
+  netPinStor_.clear();
+
+  instIdMap_.clear();
+  iTermIdMap_.clear();
+  bTermIdMap_.clear();
+  netIdMap_.clear();
   
   placeInsts_.clear();
   fixedInsts_.clear();
+  dummyInsts_.clear();
   nonPlaceInsts_.clear();
 }
 
+int64_t
+PlacerBase::memoryBytes() const {
+  int64_t bytes = getCapacityBytes(instStor_)
+    + getCapacityBytes(pinStor_)
+    + getCapacityBytes(netStor_)
+    + getCapacityBytes(rows_)
+    + getCapacityBytes(insts_)
+    + getCapacityBytes(pins_)
+    + getCapacityBytes(nets_)
+    + getCapacityBytes(instIdMap_)
+    + getCapacityBytes(iTermIdMap_)
+    + getCapacityBytes(bTermIdMap_)
+    + getCapacityBytes(netIdMap_)
+    + getCapacityBytes(placeInsts_)
+    + getCapacityBytes(fixedInsts_)
+    + getCapacityBytes(dummyInsts_)
+    + getCapacityBytes(nonPlaceInsts_);
+
+  bytes += getCapacityBytes(instPinStor_)
+    + getCapacityBytes(netPinStor_);
+
+  bytes += getCapacityBytes(freeInstSlots_)
+    + getCapacityBytes(freePinSlots_)
+    + getCapacityBytes(freeNetSlots_);
+
+  bytes += getCapacityBytes(masterOffsetBegins_)
+    + getCapacityBytes(mTermOffsets_);
+  for(auto& offsetBegins : masterOffsetBegins_) {
+    bytes += getCapacityBytes(offsetBegins);
+  }
+  return bytes;
+}
+
 int64_t 
 PlacerBase::hpwl() const {
   int64_t hpwl = 0;
-  for(auto& net : nets_) {
-    net->updateBox();
-    hpwl += net->hpwl();
+  // each net only updates its own bbox.
+#pragma omp parallel for schedule(static) reduction(+:hpwl)
+  for(size_t i=0; i<nets_.size(); i++) {
+    nets_[i]->updateBox();
+    hpwl += nets_[i]->hpwl();
   }
   return hpwl;
 }
 
 Instance* 
 PlacerBase::dbToPlace(odb::dbInst* inst) const {
-  auto instPtr = instMap_.find(inst);
-  return (instPtr == instMap_.end())? nullptr : instPtr->second;
+  return getIdMap(instIdMap_, inst->getId());
 }
 
 Pin* 
 PlacerBase::dbToPlace(odb::dbITerm* term) const {
-  auto pinPtr = pinMap_.find((void*)term);
-  return (pinPtr == pinMap_.end())? nullptr : pinPtr->second;
+  return getIdMap(iTermIdMap_, term->getId());
 }
 
 Pin* 
 PlacerBase::dbToPlace(odb::dbBTerm* term) const {
-  auto pinPtr = pinMap_.find((void*)term);
-  return (pinPtr == pinMap_.end())? nullptr : pinPtr->second;
+  return getIdMap(bTermIdMap_, term->getId());
 }
 
 Net* 
 PlacerBase::dbToPlace(odb::dbNet* net) const {
-  auto netPtr = netMap_.find(net);
-  return (netPtr == netMap_.end())? nullptr : netPtr->second;
+  return getIdMap(netIdMap_, net->getId());
+}
+
+int
+PlacerBase::instIndex(const Instance* inst) const {
+  return inst - &instStor_[0];
+}
+
+int
+PlacerBase::pinIndex(const Pin* pin) const {
+  return pin - &pinStor_[0];
+}
+
+int
+PlacerBase::netIndex(const Net* net) const {
+  return net - &netStor_[0];
 }
 
 void 
 PlacerBase::printInfo() const { 
-  log_->infoInt("NumInstances", instStor_.size());
+  log_->infoInt("NumInstances", insts_.size());
   log_->infoInt("NumPlaceInstances", placeInsts_.size());
   log_->infoInt("NumFixedInstances", fixedInsts_.size());
   log_->infoInt("NumDummyInstances", dummyInsts_.size());
@@ -1001,6 +1857,15 @@ isCoreAreaOverlap(Die& die, Instance& inst) {
   return !( rectLx >= rectUx || rectLy >= rectUy );
 }
 
+// VDD/VSS/reset nets are not placed
+static bool
+isSignalNet(odb::dbNet* net) {
+  dbSigType netType = net->getSigType();
+  return !( netType == dbSigType::GROUND ||
+      netType == dbSigType::POWER ||
+      netType == dbSigType::RESET );
+}
+
 static int64_t
 getOverlapWithCoreArea(Die& die, Instance& inst) {
   int rectLx = max(die.coreLx(), inst.lx()),
@@ -1011,6 +1876,85 @@ getOverlapWithCoreArea(Die& die, Instance& inst) {
     * static_cast<int64_t>(rectUy - rectLy);
 }
 
+// Pin's bbox center offset from the master's center,
+// on the master's (R0) coordinates.
+static odb::Point
+getMTermOffset(odb::dbMTerm* mTerm) {
+  int offsetLx = INT_MAX;
+  int offsetLy = INT_MAX;
+  int offsetUx = INT_MIN;
+  int offsetUy = INT_MIN;
 
+  for(dbMPin* mPin : mTerm->getMPins()) {
+    for(dbBox* box : mPin->getGeometry()) {
+      offsetLx = std::min(box->xMin(), offsetLx);
+      offsetLy = std::min(box->yMin(), offsetLy);
+      offsetUx = std::max(box->xMax(), offsetUx);
+      offsetUy = std::max(box->yMax(), offsetUy);
+    } 
+  }
+
+  // Pin SHAPE is NOT FOUND; 
+  // (may happen on OpenDB bug case)
+  if( offsetLx == INT_MAX || offsetLy == INT_MAX || 
+      offsetUx == INT_MIN || offsetUy == INT_MIN ) {
+    // offset is center of instances
+    return odb::Point(0, 0);
+  }
+
+  // offset is Pin BBoxs' center, so
+  // subtract the Origin coordinates (e.g. masterCenterX, masterCenterY)
+  //
+  // Transform coordinates 
+  // from (origin: 0,0) 
+  // to (origin: masterCenterX, masterCenterY)
+  //
+  dbMaster* master = mTerm->getMaster();
+  const int masterCenterX = master->getWidth()/2;
+  const int masterCenterY = master->getHeight()/2;
+  return odb::Point( (offsetLx + offsetUx)/2 - masterCenterX,
+      (offsetLy + offsetUy)/2 - masterCenterY );
+}
+
+template <class T>
+static void
+setIdMap(std::vector<T*>& idMap, unsigned id, T* obj) {
+  if( idMap.size() <= id ) {
+    idMap.resize(id+1, nullptr);
+  }
+  idMap[id] = obj;
+}
+
+template <class T>
+static T*
+getIdMap(const std::vector<T*>& idMap, unsigned id) {
+  return (id < idMap.size())? idMap[id] : nullptr;
 }
 
+// Grows a full stor by doubling before push_back.
+// rebase(oldBegin, newBegin) moves references to stor 
+// while both storages are alive.
+template <class T, class Rebase>
+static void
+growStor(std::vector<T>& stor, Rebase rebase) {
+  if( stor.size() < stor.capacity() ) {
+    return;
+  }
+  std::vector<T> newStor;
+  newStor.reserve(std::max(2 * stor.capacity(), static_cast<size_t>(16)));
+  newStor.insert(newStor.end(), stor.begin(), stor.end());
+  rebase(stor.data(), newStor.data());
+  stor.swap(newStor);
+}
+
+template <class T>
+static void
+rebasePtrs(std::vector<T*>& ptrs, const T* oldBegin, T* newBegin) {
+  for(auto& ptr : ptrs) {
+    if( ptr ) {
+      ptr = newBegin + (ptr - oldBegin);
+    }
+  }
+}
+
+}
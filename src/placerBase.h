@@ -2,9 +2,10 @@
 #define __PLACER_BASE__
 
 #include <vector>
-#include <unordered_map>
 #include <memory>
 
+#include "pointerRange.h"
+
 namespace odb {
 class dbDatabase;
 
@@ -17,8 +18,11 @@ class dbPlacementStatus;
 class dbSigType;
 
 class dbBox;
+class dbMTerm;
+class dbBlock;
 
 class Rect;
+class Point;
 }
 
 namespace replace {
@@ -28,13 +32,16 @@ class Net;
 class GCell;
 
 class Logger;
+class PlacerBaseCallBack;
 
 class Instance {
 public:
   Instance();
   Instance(odb::dbInst* inst);
+  // for dummy instances
   Instance(int lx, int ly, int ux, int uy);
-  ~Instance();
+  // for db-less real instances (See PlacerBaseData)
+  Instance(int lx, int ly, int ux, int uy, bool isFixed);
 
   odb::dbInst* dbInst() const { return inst_; }
 
@@ -51,6 +58,11 @@ public:
   // will have inst_ as nullptr
   bool isDummy() const;
 
+  // removed by a dbInst destroy (See PlacerBaseCallBack).
+  // Its slot is reused after the next PlacerBase::sync().
+  bool isRemoved() const;
+  void setRemoved();
+
   void setLocation(int x, int y);
   void setCenterLocation(int x, int y);
 
@@ -72,25 +84,36 @@ public:
   void setExtId(int extId);
   int extId() const { return extId_; }
 
-  void addPin(Pin* pin);
-  const std::vector<Pin*> & pins() const { return pins_; }
+  // read location and size from dbInst
+  void updateCoordi();
+
+  // pins are stored in PlacerBase (See PlacerBase::initPinLists)
+  void setPins(PointerRange<Pin> pins);
+  PointerRange<Pin> pins() const { return pins_; }
 
 private:
   odb::dbInst* inst_;
-  std::vector<Pin*> pins_;
+  PointerRange<Pin> pins_;
   int lx_;
   int ly_;
   int ux_;
   int uy_;
   int extId_;
+
+  // real instance / fixed status when inst_ is nullptr
+  unsigned char dbLessInstField_:1;
+  unsigned char dbLessFixedField_:1;
+  unsigned char removedField_:1;
 };
 
 class Pin {
 public:
   Pin();
   Pin(odb::dbITerm* iTerm);
+  // mTermOffset : pin center offset from master's center
+  //               (See getMTermOffset in placerBase.cpp)
+  Pin(odb::dbITerm* iTerm, const odb::Point& mTermOffset);
   Pin(odb::dbBTerm* bTerm);
-  ~Pin();
 
   odb::dbITerm* dbITerm() const;
   odb::dbBTerm* dbBTerm() const;
@@ -126,9 +149,23 @@ public:
 
   bool isPlaceInstConnected() const;
 
+  // removed by a disconnect or its instance's/net's destroy
+  bool isRemoved() const;
+  void setRemoved();
+
   Instance* instance() const { return inst_; }
   Net* net() const { return net_; }
 
+  // read location from db
+  void updateCoordi(odb::dbITerm* iTerm, const odb::Point& mTermOffset);
+  void updateCoordi(odb::dbBTerm* bTerm);
+
+  // for db-less pins.
+  // offset from instance's center for instance pins, 
+  // location for IO pins
+  void setOffsetCoordi(int offsetCx, int offsetCy);
+  void setCoordi(int cx, int cy);
+
 private:
   void* term_;
   Instance* inst_;
@@ -152,16 +189,15 @@ private:
   unsigned char minPinYField_:1;
   unsigned char maxPinXField_:1;
   unsigned char maxPinYField_:1;
+  unsigned char removedField_:1;
 
   void updateCoordi(odb::dbITerm* iTerm);
-  void updateCoordi(odb::dbBTerm* bTerm);
 };
 
 class Net {
 public:
   Net();
   Net(odb::dbNet* net);
-  ~Net();
 
   int lx() const;
   int ly() const;
@@ -175,20 +211,26 @@ public:
 
   void updateBox();
 
-  const std::vector<Pin*> & pins() const { return pins_; }
+  PointerRange<Pin> pins() const { return pins_; }
 
   odb::dbNet* dbNet() const { return net_; }
   odb::dbSigType getSigType() const;
 
-  void addPin(Pin* pin);
+  // pins are stored in PlacerBase (See PlacerBase::initPinLists)
+  void setPins(PointerRange<Pin> pins);
+
+  // removed by a dbNet destroy
+  bool isRemoved() const;
+  void setRemoved();
 
 private:
   odb::dbNet* net_;
-  std::vector<Pin*> pins_;
+  PointerRange<Pin> pins_;
   int lx_;
   int ly_;
   int ux_;
   int uy_;
+  unsigned char removedField_:1;
 };
 
 class Die {
@@ -199,6 +241,8 @@ public:
 
   void setDieBox(odb::dbBox* dieBox);
   void setCoreBox(odb::Rect* coreBox);
+  void setDieBox(int lx, int ly, int ux, int uy);
+  void setCoreBox(int lx, int ly, int ux, int uy);
 
   int dieLx() const { return dieLx_; }
   int dieLy() const { return dieLy_; }
@@ -230,12 +274,61 @@ private:
   int coreUy_;
 };
 
+// db-less placement model to build or dump PlacerBase
+// (e.g. snapshot, bookshelf).
+//
+// insts : real instances only. Dummy instances are built from rows.
+// pins : inst/net are indices of insts/nets. inst is -1 on IO pins.
+//        (x, y) is the offset from the instance's center,
+//        or the location on IO pins.
+// rows : rows' bbox for fragmented-row handling.
+class PlacerBaseData {
+public:
+  class Box {
+  public:
+    int lx, ly, ux, uy;
+  };
+
+  class InstData {
+  public:
+    Box box;
+    bool isFixed;
+  };
+
+  class PinData {
+  public:
+    int inst;
+    int net;
+    int x;
+    int y;
+  };
+
+  Box die;
+  Box core;
+  int siteSizeX;
+  int siteSizeY;
+
+  std::vector<InstData> insts;
+  std::vector<PinData> pins;
+  int netCnt;
+  std::vector<Box> rows;
+
+  PlacerBaseData();
+};
+
 class PlacerBase {
+  friend class PlacerBaseCallBack;
+
 public:
   PlacerBase();
   PlacerBase(odb::dbDatabase* db, std::shared_ptr<Logger> log);
+  PlacerBase(const PlacerBaseData& data, std::shared_ptr<Logger> log);
   ~PlacerBase();
 
+  // dump the current model. 
+  // insts are in the same order as insts(), without dummy instances.
+  PlacerBaseData toData() const;
+
   const std::vector<Instance*>& insts() const { return insts_; }
   const std::vector<Pin*>& pins() const { return pins_; }
   const std::vector<Net*>& nets() const { return nets_; }
@@ -259,12 +352,44 @@ public:
   Pin* dbToPlace(odb::dbBTerm* pin) const;
   Net* dbToPlace(odb::dbNet* net) const;
 
+  // index of objects in PlacerBase's storages, 
+  // less than instIndexCnt()/pinIndexCnt()/netIndexCnt().
+  // Indices are kept by sync(), and objects added by the 
+  // dbBlock callbacks take removed objects' indices or new ones.
+  // They are the insts()/pins()/nets() indices until then.
+  int instIndex(const Instance* inst) const;
+  int pinIndex(const Pin* pin) const;
+  int netIndex(const Net* net) const;
+  int instIndexCnt() const { return instStor_.size(); }
+  int pinIndexCnt() const { return pinStor_.size(); }
+  int netIndexCnt() const { return netStor_.size(); }
+
   int siteSizeX() const { return siteSizeX_; }
   int siteSizeY() const { return siteSizeY_; }
 
   int64_t hpwl() const;
   void printInfo() const;
 
+  // heap bytes of the placer objects and maps (capacity based)
+  int64_t memoryBytes() const;
+
+  // Logger of the current global_placement call.
+  // PlacerBase outlives the Logger it was built with.
+  void setLogger(std::shared_ptr<Logger> log);
+
+  // Apply dbBlock changes since init() or the last sync() in place;
+  // instances' locations, swapped masters and placement status.
+  // Netlist edits are already patched into the storages by the
+  // dbBlock callbacks, and sync() rebuilds the lists from them.
+  // Returns false if fixed instances or rows are changed, 
+  // or the chip's block is not the one PlacerBase was built from,
+  // then PlacerBase must be rebuilt.
+  bool sync();
+
+  // no netlist callback since init() or the last sync(),
+  // i.e. the lists are up to date except locations.
+  bool isSynced() const;
+
   int64_t placeInstsArea() const { return placeInstsArea_; }
   int64_t nonPlaceInstsArea() const { return nonPlaceInstsArea_; }
   int64_t macroInstsArea() const { return macroInstsArea_; }
@@ -280,13 +405,24 @@ private:
   std::vector<Pin> pinStor_;
   std::vector<Net> netStor_;
 
+  std::vector<PlacerBaseData::Box> rows_;
+
   std::vector<Instance*> insts_;
   std::vector<Pin*> pins_;
   std::vector<Net*> nets_;
 
-  std::unordered_map<odb::dbInst*, Instance*> instMap_;
-  std::unordered_map<void*, Pin*> pinMap_;
-  std::unordered_map<odb::dbNet*, Net*> netMap_;
+  // instances' and nets' pin lists, concatenated in 
+  // instStor_/netStor_ order. Instance/Net hold ranges of them.
+  std::vector<Pin*> instPinStor_;
+  std::vector<Pin*> netPinStor_;
+
+  // db object to placer object references,
+  // indexed by OpenDB's getId(). 
+  // nullptr if there is no matching object.
+  std::vector<Instance*> instIdMap_;
+  std::vector<Pin*> iTermIdMap_;
+  std::vector<Pin*> bTermIdMap_;
+  std::vector<Net*> netIdMap_;
 
   std::vector<Instance*> placeInsts_;
   std::vector<Instance*> fixedInsts_;
@@ -305,8 +441,48 @@ private:
   int64_t macroInstsArea_;
   int64_t stdInstsArea_;
 
+  // journal of dbBlock changes (See sync())
+  // and the block it is subscribed to
+  std::unique_ptr<PlacerBaseCallBack> callBack_;
+  odb::dbBlock* block_;
+
+  // removed slots of instStor_/pinStor_/netStor_ as of the 
+  // last sync(), reused by the callbacks' new objects.
+  std::vector<int> freeInstSlots_;
+  std::vector<int> freePinSlots_;
+  std::vector<int> freeNetSlots_;
+
+  // pin center offsets of dbMTerm, shared by all instances.
+  // A master's mTerms take a range of mTermOffsets_ 
+  // in dbMTerm::getIndex() order, starting at 
+  // masterOffsetBegins_[dbLib id][dbMaster id] (-1 if not filled yet).
+  std::vector<std::vector<int>> masterOffsetBegins_;
+  std::vector<std::pair<int, int>> mTermOffsets_;
+
   void init();
+  void init(const PlacerBaseData& data);
   void initInstsForFragmentedRow();
+  void initInstsCategory();
+  void initPinLists();
+  odb::Point mTermOffset(odb::dbMTerm* mTerm);
+
+  // netlist patches from the dbBlock callbacks.
+  // Storages and id maps are updated in place; 
+  // the lists and pin lists are rebuilt by sync().
+  void addInstance(odb::dbInst* inst);
+  void removeInstance(odb::dbInst* inst);
+  void addNet(odb::dbNet* net);
+  void removeNet(odb::dbNet* net);
+  void addPin(odb::dbITerm* iTerm);
+  void addPin(odb::dbBTerm* bTerm);
+  void removePin(odb::dbITerm* iTerm);
+  void removePin(odb::dbBTerm* bTerm);
+
+  // slots for new objects, from the free slots or appended.
+  // Growing a storage moves every reference to it.
+  Instance* newInstanceSlot();
+  Pin* newPinSlot();
+  Net* newNetSlot();
 
   void reset();
 };
@@ -1,6 +1,10 @@
 #ifndef __REPLACE_COORDI__
 #define __REPLACE_COORDI__
 
+#include <vector>
+
+#include "largeArray.h"
+
 namespace replace {
 
 class FloatPoint {
@@ -18,6 +22,10 @@ class IntPoint {
   IntPoint();
   IntPoint(int x, int y);
 };
+
+// per-gCell coordinates/gradients of Nesterov place
+typedef std::vector<FloatPoint, LargeArrayAllocator<FloatPoint>> 
+  FloatPointArray;
 }
 
 #endif
@@ -0,0 +1,32 @@
+#ifndef __REPLACE_POINTER_RANGE__
+#define __REPLACE_POINTER_RANGE__
+
+#include <cstddef>
+
+namespace replace {
+
+// Non-owning view of a contiguous pointer list, e.g. an instance's
+// pins in PlacerBase's pin list storage.
+// The storage is filled once (count-then-fill) and
+// owned by PlacerBase/NesterovBase, so objects hold no heap memory.
+template <class T>
+class PointerRange {
+public:
+  PointerRange() : begin_(nullptr), size_(0) {}
+  PointerRange(T* const* begin, size_t size)
+    : begin_(begin), size_(size) {}
+
+  T* const* begin() const { return begin_; }
+  T* const* end() const { return begin_ + size_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  T* operator[](size_t idx) const { return begin_[idx]; }
+
+private:
+  T* const* begin_;
+  size_t size_;
+};
+
+}
+
+#endif
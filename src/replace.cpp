@@ -4,6 +4,8 @@
 #include "placerBase.h"
 #include "nesterovBase.h"
 #include "logger.h"
+#include "snapshot.h"
+#include "largeArray.h"
 #include <iostream>
 
 namespace replace {
@@ -21,6 +23,8 @@ Replace::Replace()
   initialPlaceMaxSolverIter_(100),
   initialPlaceMaxFanout_(200),
   initialPlaceNetWeightScale_(800),
+  initialPlaceSolver_("bicgstab"),
+  initialPlacePrecond_("none"),
   nesterovPlaceMaxIter_(2000),
   binGridCntX_(0), binGridCntY_(0), 
   overflow_(0.1), density_(1.0),
@@ -28,6 +32,11 @@ Replace::Replace()
   initWireLengthCoef_(0.25),
   minPhiCoef_(0.95), maxPhiCoef_(1.05),
   referenceHpwl_(446000000),
+  coarseFillerLevel_(0),
+  localityOrder_(false),
+  localityOrderInterval_(0),
+  hugePageMode_(false),
+  firstTouchMode_(false),
   incrementalPlaceMode_(false),
   verbose_(0) {
 };
@@ -49,6 +58,8 @@ void Replace::reset() {
   initialPlaceMaxSolverIter_ = 100;
   initialPlaceMaxFanout_ = 200;
   initialPlaceNetWeightScale_ = 800;
+  initialPlaceSolver_ = "bicgstab";
+  initialPlacePrecond_ = "none";
 
   nesterovPlaceMaxIter_ = 2000;
   binGridCntX_ = binGridCntY_ = 0;
@@ -59,9 +70,16 @@ void Replace::reset() {
   minPhiCoef_ = 0.95;
   maxPhiCoef_ = 1.05;
   referenceHpwl_= 446000000;
+  coarseFillerLevel_ = 0;
+  localityOrder_ = false;
+  localityOrderInterval_ = 0;
+  hugePageMode_ = false;
+  firstTouchMode_ = false;
 
   incrementalPlaceMode_ = false;
   verbose_ = 0;
+  profileJsonFile_ = "";
+  metricsFile_ = "";
 }
 
 void Replace::setDb(odb::dbDatabase* db) {
@@ -72,7 +90,7 @@ void Replace::setSta(sta::dbSta* sta) {
 }
 void Replace::doInitialPlace() {
   log_ = std::make_shared<Logger>("REPL", verbose_);
-  pb_ = std::make_shared<PlacerBase>(db_, log_);
+  initPlacerBase();
 
   InitialPlaceVars ipVars;
   ipVars.maxIter = initialPlaceMaxIter_;
@@ -81,10 +99,58 @@ void Replace::doInitialPlace() {
   ipVars.maxFanout = initialPlaceMaxFanout_;
   ipVars.netWeightScale = initialPlaceNetWeightScale_;
   ipVars.incrementalPlaceMode = incrementalPlaceMode_;
+
+  if( initialPlaceSolver_ == "cg" ) {
+    ipVars.solver = InitialPlaceSolver::CG;
+  }
+  else if( initialPlaceSolver_ == "bicgstab" ) {
+    ipVars.solver = InitialPlaceSolver::BiCGSTAB;
+  }
+  else {
+    log_->error("Unknown initial place solver: " + initialPlaceSolver_, 5);
+  }
+
+  if( initialPlacePrecond_ == "none" ) {
+    ipVars.precond = InitialPlacePrecond::None;
+  }
+  else if( initialPlacePrecond_ == "jacobi" ) {
+    ipVars.precond = InitialPlacePrecond::Jacobi;
+  }
+  else if( initialPlacePrecond_ == "ichol" ) {
+    ipVars.precond = InitialPlacePrecond::IncompleteCholesky;
+  }
+  else {
+    log_->error("Unknown initial place preconditioner: "
+        + initialPlacePrecond_, 5);
+  }
   
   std::unique_ptr<InitialPlace> ip(new InitialPlace(ipVars, pb_, log_));
   ip_ = std::move(ip);
   ip_->doBicgstabPlace();
+  log_->flush();
+}
+
+// PlacerBase and NesterovBase are kept between global_placement 
+// calls and patched on netlist changes. Rebuild them only when 
+// PlacerBase can't be synced.
+void Replace::initPlacerBase() {
+  if( pb_ ) {
+    pb_->setLogger(log_);
+  }
+  if( !pb_ || !pb_->sync() ) {
+    ip_.reset();
+    np_.reset();
+    nb_ = nullptr;
+    pb_ = std::make_shared<PlacerBase>(db_, log_);
+  }
+}
+
+bool Replace::writeSnapshot(const std::string& fileName) {
+  if( !log_ ) {
+    log_ = std::make_shared<Logger>("REPL", verbose_);
+  }
+  initPlacerBase();
+  return replace::writeSnapshot(fileName, pb_->toData(), log_);
 }
 
 void Replace::doNesterovPlace() {
@@ -92,8 +158,13 @@ void Replace::doNesterovPlace() {
     log_ = std::make_shared<Logger>("REPL", verbose_);
   }
 
-  if( !pb_ ) {
-    pb_ = std::make_shared<PlacerBase>(db_, log_);
+  // doInitialPlace has synced PlacerBase, 
+  // unless this is called alone after netlist changes.
+  if( !pb_ || !pb_->isSynced() ) {
+    initPlacerBase();
+  }
+  else {
+    pb_->setLogger(log_);
   }
 
   NesterovBaseVars nbVars;
@@ -109,7 +180,18 @@ void Replace::doNesterovPlace() {
     nbVars.binCntY = binGridCntY_;
   }
 
-  nb_ = std::make_shared<NesterovBase>(nbVars, pb_, log_);
+  nbVars.coarseFillerLevel = coarseFillerLevel_;
+
+  // before the large arrays of NesterovBase/NesterovPlace
+  setLargeArrayOptions(hugePageMode_, firstTouchMode_, log_);
+
+  // NesterovBase is kept with PlacerBase (See initPlacerBase)
+  if( nb_ ) {
+    nb_->sync(nbVars, log_);
+  }
+  else {
+    nb_ = std::make_shared<NesterovBase>(nbVars, pb_, log_);
+  }
 
   NesterovPlaceVars npVars;
 
@@ -120,11 +202,93 @@ void Replace::doNesterovPlace() {
   npVars.initWireLengthCoef = initWireLengthCoef_;
   npVars.targetOverflow = overflow_;
   npVars.maxNesterovIter = nesterovPlaceMaxIter_; 
+  npVars.metricsFile = metricsFile_;
+  npVars.localityOrder = localityOrder_;
+  npVars.localityOrderInterval = localityOrderInterval_;
 
   std::unique_ptr<NesterovPlace> np(new NesterovPlace(npVars, pb_, nb_, log_));
   np_ = std::move(np);
 
   np_->doNesterovPlace();
+
+  // phases of this global_placement call
+  log_->reportProfile(1);
+  if( !profileJsonFile_.empty()
+      && !log_->writeProfileJson(profileJsonFile_) ) {
+    log_->warn("Cannot write profile: " + profileJsonFile_, 8);
+  }
+  log_->resetProfile();
+  reportMemory(1);
+  log_->flush();
+}
+
+// subsystems in report order
+static const char* memorySubsystems[] = {
+  "placer_base", "nesterov_base", "bin_grid", "fft", 
+  "nesterov_place", "initial_place"
+};
+
+static const char* memorySubsystemNames[] = {
+  "PlacerBase", "NesterovBase", "BinGrid", "FFT",
+  "NesterovPlace", "InitialPlace"
+};
+
+int64_t Replace::getMemoryBytes(const std::string& subsystem) {
+  if( subsystem == "placer_base" ) {
+    return (pb_)? pb_->memoryBytes() : 0;
+  }
+  else if( subsystem == "nesterov_base" ) {
+    return (nb_)? nb_->memoryBytes() : 0;
+  }
+  else if( subsystem == "bin_grid" ) {
+    return (nb_)? nb_->binGridMemoryBytes() : 0;
+  }
+  else if( subsystem == "fft" ) {
+    return (nb_)? nb_->fftMemoryBytes() : 0;
+  }
+  else if( subsystem == "nesterov_place" ) {
+    return (np_)? np_->memoryBytes() : 0;
+  }
+  else if( subsystem == "initial_place" ) {
+    return (ip_)? ip_->memoryBytes() : 0;
+  }
+  else if( subsystem == "total" ) {
+    int64_t bytes = 0;
+    for(const char* name : memorySubsystems) {
+      bytes += getMemoryBytes(name);
+    }
+    return bytes;
+  }
+  else if( subsystem == "large_array" ) {
+    return getLargeArrayBytes();
+  }
+  else if( subsystem == "huge_page" ) {
+    return getHugePageBytes();
+  }
+  else if( subsystem == "peak_rss" ) {
+    return Logger::getPeakRssBytes();
+  }
+  return -1;
+}
+
+void Replace::reportMemory(int verbose) {
+  if( !log_ ) {
+    log_ = std::make_shared<Logger>("REPL", verbose_);
+  }
+  if( !log_->isEnabled(verbose) ) {
+    return;
+  }
+  const int subsystemCnt 
+    = sizeof(memorySubsystems) / sizeof(memorySubsystems[0]);
+  for(int i=0; i<subsystemCnt; i++) {
+    log_->infoMemory(memorySubsystemNames[i], 
+        getMemoryBytes(memorySubsystems[i]), verbose);
+  }
+  log_->infoMemory("Total", getMemoryBytes("total"), verbose);
+  log_->infoMemory("LargeArray", getMemoryBytes("large_array"), verbose);
+  log_->infoMemory("HugePage", getMemoryBytes("huge_page"), verbose);
+  log_->infoMemory("PeakRss", getMemoryBytes("peak_rss"), verbose);
+  log_->flush();
 }
 
 
@@ -153,6 +317,16 @@ Replace::setInitialPlaceNetWeightScale(float scale) {
   initialPlaceNetWeightScale_ = scale;
 }
 
+void
+Replace::setInitialPlaceSolver(const std::string& solver) {
+  initialPlaceSolver_ = solver;
+}
+
+void
+Replace::setInitialPlacePrecond(const std::string& precond) {
+  initialPlacePrecond_ = precond;
+}
+
 void
 Replace::setNesterovPlaceMaxIter(int iter) {
   nesterovPlaceMaxIter_ = iter;
@@ -198,6 +372,31 @@ Replace::setMaxPhiCoef(float maxPhiCoef) {
   maxPhiCoef_ = maxPhiCoef;
 }
 
+void
+Replace::setCoarseFillerLevel(int level) {
+  coarseFillerLevel_ = level;
+}
+
+void
+Replace::setLocalityOrder(bool mode) {
+  localityOrder_ = mode;
+}
+
+void
+Replace::setLocalityOrderInterval(int interval) {
+  localityOrderInterval_ = interval;
+}
+
+void
+Replace::setHugePageMode(bool mode) {
+  hugePageMode_ = mode;
+}
+
+void
+Replace::setFirstTouchMode(bool mode) {
+  firstTouchMode_ = mode;
+}
+
 void
 Replace::setReferenceHpwl(float refHpwl) {
   referenceHpwl_ = refHpwl;
@@ -213,5 +412,15 @@ Replace::setVerboseLevel(int verbose) {
   verbose_ = verbose;
 }
 
+void
+Replace::setProfileJsonFile(const std::string& fileName) {
+  profileJsonFile_ = fileName;
+}
+
+void
+Replace::setMetricsFile(const std::string& fileName) {
+  metricsFile_ = fileName;
+}
+
 }
 
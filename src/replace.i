@@ -29,6 +29,28 @@ replace_nesterov_place_cmd()
   replace->doNesterovPlace();
 }
 
+void
+replace_report_memory_cmd()
+{
+  Replace* replace = getReplace();
+  replace->reportMemory();
+}
+
+// bytes as double to keep 64-bit values in Tcl
+double
+replace_get_memory_bytes_cmd(const char* subsystem)
+{
+  Replace* replace = getReplace();
+  return replace->getMemoryBytes(subsystem);
+}
+
+bool
+replace_write_snapshot_cmd(const char* file_name)
+{
+  Replace* replace = getReplace();
+  return replace->writeSnapshot(file_name);
+}
+
 void
 set_replace_density_cmd(float density)
 {
@@ -50,6 +72,20 @@ set_replace_initial_place_max_fanout_cmd(int fanout)
   replace->setInitialPlaceMaxFanout(fanout);
 }
 
+void
+set_replace_initial_place_solver_cmd(const char* solver)
+{
+  Replace* replace = getReplace();
+  replace->setInitialPlaceSolver(solver);
+}
+
+void
+set_replace_initial_place_precond_cmd(const char* precond)
+{
+  Replace* replace = getReplace();
+  replace->setInitialPlacePrecond(precond);
+}
+
 void
 set_replace_nesv_place_iter_cmd(int iter)
 {
@@ -92,6 +128,41 @@ set_replace_max_phi_coef_cmd(float max_phi_coef)
   replace->setMaxPhiCoef(max_phi_coef);
 }
 
+void
+set_replace_coarse_filler_level_cmd(int level)
+{
+  Replace* replace = getReplace();
+  replace->setCoarseFillerLevel(level);
+}
+
+void
+set_replace_locality_order_cmd(bool mode)
+{
+  Replace* replace = getReplace();
+  replace->setLocalityOrder(mode);
+}
+
+void
+set_replace_locality_order_interval_cmd(int interval)
+{
+  Replace* replace = getReplace();
+  replace->setLocalityOrderInterval(interval);
+}
+
+void
+set_replace_huge_page_mode_cmd(bool mode)
+{
+  Replace* replace = getReplace();
+  replace->setHugePageMode(mode);
+}
+
+void
+set_replace_first_touch_mode_cmd(bool mode)
+{
+  Replace* replace = getReplace();
+  replace->setFirstTouchMode(mode);
+}
+
 void
 set_replace_init_density_penalty_factor_cmd(float penaltyFactor)
 {
@@ -120,6 +191,20 @@ set_replace_verbose_level_cmd(int verbose)
   replace->setVerboseLevel(verbose);
 }
 
+void
+set_replace_profile_json_cmd(const char* file_name)
+{
+  Replace* replace = getReplace();
+  replace->setProfileJsonFile(file_name);
+}
+
+void
+set_replace_metrics_file_cmd(const char* file_name)
+{
+  Replace* replace = getReplace();
+  replace->setMetricsFile(file_name);
+}
+
 
 
 %} // inline
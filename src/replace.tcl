@@ -3,6 +3,11 @@ sta::define_cmd_args "global_placement" {
   [-timing_driven]\
   [-incremental]\
   [-density target_density]\
+  [-coarse_filler_level level]\
+  [-locality_order]\
+  [-locality_order_interval iter]\
+  [-huge_pages]\
+  [-numa_first_touch]\
     [-bin_grid_count grid_count]}
 
 proc global_placement { args } {
@@ -11,8 +16,11 @@ proc global_placement { args } {
       -init_density_penalty -init_wirelength_coef \
       -min_phi_coef -max_phi_coef -overflow \
       -initial_place_max_iter -initial_place_max_fanout \
-      -verbose_level} \
-      flags {-skip_initial_place -timing_driven -incremental}
+      -initial_place_solver -initial_place_precond \
+      -verbose_level -profile_json -metrics_file \
+      -coarse_filler_level -locality_order_interval} \
+      flags {-skip_initial_place -timing_driven -incremental -locality_order \
+        -huge_pages -numa_first_touch}
     
   set target_density 0.7
   if { [info exists keys(-density)] } {
@@ -40,6 +48,24 @@ proc global_placement { args } {
     set_replace_initial_place_max_fanout_cmd $initial_place_max_fanout
   }
 
+  if { [info exists keys(-initial_place_solver)] } {
+    set initial_place_solver $keys(-initial_place_solver)
+    if { [lsearch -exact {cg bicgstab} $initial_place_solver] == -1 } {
+      puts "Error: -initial_place_solver must be cg or bicgstab."
+      return
+    }
+    set_replace_initial_place_solver_cmd $initial_place_solver
+  }
+
+  if { [info exists keys(-initial_place_precond)] } {
+    set initial_place_precond $keys(-initial_place_precond)
+    if { [lsearch -exact {none jacobi ichol} $initial_place_precond] == -1 } {
+      puts "Error: -initial_place_precond must be none, jacobi or ichol."
+      return
+    }
+    set_replace_initial_place_precond_cmd $initial_place_precond
+  }
+
 
   # hidden parameter to control the RePlAce divergence
   if { [info exists keys(-min_phi_coef)] } { 
@@ -72,12 +98,58 @@ proc global_placement { args } {
     set_replace_overflow_cmd $overflow
   }
 
+  if { [info exists keys(-coarse_filler_level)] } {
+    set coarse_filler_level $keys(-coarse_filler_level)
+    sta::check_positive_integer "-coarse_filler_level" $coarse_filler_level
+    set_replace_coarse_filler_level_cmd $coarse_filler_level
+  } else {
+    set_replace_coarse_filler_level_cmd 0
+  }
+
+  if { [info exists flags(-locality_order)] } {
+    set_replace_locality_order_cmd 1
+  } else {
+    set_replace_locality_order_cmd 0
+  }
+
+  if { [info exists keys(-locality_order_interval)] } {
+    set locality_order_interval $keys(-locality_order_interval)
+    sta::check_positive_integer "-locality_order_interval" $locality_order_interval
+    set_replace_locality_order_interval_cmd $locality_order_interval
+  } else {
+    set_replace_locality_order_interval_cmd 0
+  }
+
+  if { [info exists flags(-huge_pages)] } {
+    set_replace_huge_page_mode_cmd 1
+  } else {
+    set_replace_huge_page_mode_cmd 0
+  }
+
+  if { [info exists flags(-numa_first_touch)] } {
+    set_replace_first_touch_mode_cmd 1
+  } else {
+    set_replace_first_touch_mode_cmd 0
+  }
+
   if { [info exists keys(-verbose_level)] } {
     set verbose_level $keys(-verbose_level)
     sta::check_positive_integer "-verbose_level" $verbose_level
     set_replace_verbose_level_cmd $verbose_level
   } 
 
+  if { [info exists keys(-profile_json)] } {
+    set_replace_profile_json_cmd $keys(-profile_json)
+  } else {
+    set_replace_profile_json_cmd ""
+  }
+
+  if { [info exists keys(-metrics_file)] } {
+    set_replace_metrics_file_cmd $keys(-metrics_file)
+  } else {
+    set_replace_metrics_file_cmd ""
+  }
+
   if { [info exists keys(-bin_grid_count)] } {
     set bin_grid_count  $keys(-bin_grid_count)
     sta::check_positive_integer "-bin_grid_count" $bin_grid_count
@@ -95,3 +167,40 @@ proc global_placement { args } {
     puts "Error: no rows defined in design. Use initialize_floorplan to add rows."
   }
 }
+
+sta::define_cmd_args "write_global_placement_snapshot" { file_name }
+
+proc write_global_placement_snapshot { args } {
+  sta::check_argc_eq1 "write_global_placement_snapshot" $args
+
+  if { [ord::db_has_rows] } {
+    if { ![replace_write_snapshot_cmd [lindex $args 0]] } {
+      puts "Error: failed to write the snapshot."
+    }
+  } else {
+    puts "Error: no rows defined in design. Use initialize_floorplan to add rows."
+  }
+}
+
+sta::define_cmd_args "report_global_placement_memory" {}
+
+proc report_global_placement_memory { args } {
+  sta::check_argc_eq0 "report_global_placement_memory" $args
+  replace_report_memory_cmd
+}
+
+sta::define_cmd_args "global_placement_memory" { subsystem }
+
+# returns bytes of placer_base, nesterov_base, bin_grid, fft,
+# nesterov_place, initial_place, total, large_array, huge_page
+# or peak_rss.
+proc global_placement_memory { args } {
+  sta::check_argc_eq1 "global_placement_memory" $args
+  set subsystem [lindex $args 0]
+  set bytes [replace_get_memory_bytes_cmd $subsystem]
+  if { $bytes < 0 } {
+    puts "Error: unknown subsystem $subsystem."
+    return
+  }
+  return [expr {wide($bytes)}]
+}
@@ -0,0 +1,222 @@
+//
+// replace_bench : standalone global placement from a snapshot
+// (See snapshot.h and write_global_placement_snapshot)
+// or a Bookshelf design (See bookshelf.h)
+//
+// Usage: replace_bench <snapshot|.aux> [-density val] [-overflow val]
+//          [-skip_initial_place] [-verbose_level val]
+//          [-scale val] [-output_pl file] [-profile_json file]
+//          [-metrics_file file] [-coarse_filler_level val]
+//          [-locality_order] [-locality_order_interval val]
+//          [-huge_pages] [-numa_first_touch]
+//
+
+#include "placerBase.h"
+#include "nesterovBase.h"
+#include "initialPlace.h"
+#include "nesterovPlace.h"
+#include "snapshot.h"
+#include "bookshelf.h"
+#include "logger.h"
+#include "largeArray.h"
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <chrono>
+
+using namespace std;
+using namespace replace;
+
+static double
+getElapsed(std::chrono::steady_clock::time_point startTime) {
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - startTime).count();
+}
+
+static bool
+isAuxFile(const string& fileName) {
+  const string ext = ".aux";
+  return fileName.size() >= ext.size()
+    && fileName.compare(fileName.size() - ext.size(),
+        ext.size(), ext) == 0;
+}
+
+static void
+printUsage() {
+  cout << "Usage: replace_bench <snapshot|.aux> [-density val]"
+    << " [-overflow val]" << endl
+    << "         [-skip_initial_place] [-verbose_level val]" << endl
+    << "         [-scale val] [-output_pl file] [-profile_json file]"
+    << endl
+    << "         [-metrics_file file] [-coarse_filler_level val]" 
+    << endl
+    << "         [-locality_order] [-locality_order_interval val]"
+    << endl
+    << "         [-huge_pages] [-numa_first_touch]" << endl;
+}
+
+int
+main(int argc, char* argv[]) {
+  if( argc < 2 ) {
+    printUsage();
+    return 1;
+  }
+
+  string fileName = argv[1];
+  float density = 1.0;
+  float overflow = 0.1;
+  bool skipInitialPlace = false;
+  int verbose = 0;
+  int scale = 1;
+  string outputPlFileName;
+  string profileJsonFileName;
+  string metricsFileName;
+  int coarseFillerLevel = 0;
+  bool localityOrder = false;
+  int localityOrderInterval = 0;
+  bool hugePageMode = false;
+  bool firstTouchMode = false;
+
+  for(int i=2; i<argc; i++) {
+    string arg = argv[i];
+    if( arg == "-density" && i+1 < argc ) {
+      density = atof(argv[++i]);
+    }
+    else if( arg == "-overflow" && i+1 < argc ) {
+      overflow = atof(argv[++i]);
+    }
+    else if( arg == "-verbose_level" && i+1 < argc ) {
+      verbose = atoi(argv[++i]);
+    }
+    else if( arg == "-scale" && i+1 < argc ) {
+      scale = atoi(argv[++i]);
+    }
+    else if( arg == "-output_pl" && i+1 < argc ) {
+      outputPlFileName = argv[++i];
+    }
+    else if( arg == "-profile_json" && i+1 < argc ) {
+      profileJsonFileName = argv[++i];
+    }
+    else if( arg == "-metrics_file" && i+1 < argc ) {
+      metricsFileName = argv[++i];
+    }
+    else if( arg == "-coarse_filler_level" && i+1 < argc ) {
+      coarseFillerLevel = atoi(argv[++i]);
+    }
+    else if( arg == "-locality_order_interval" && i+1 < argc ) {
+      localityOrderInterval = atoi(argv[++i]);
+    }
+    else if( arg == "-locality_order" ) {
+      localityOrder = true;
+    }
+    else if( arg == "-huge_pages" ) {
+      hugePageMode = true;
+    }
+    else if( arg == "-numa_first_touch" ) {
+      firstTouchMode = true;
+    }
+    else if( arg == "-skip_initial_place" ) {
+      skipInitialPlace = true;
+    }
+    else {
+      printUsage();
+      return 1;
+    }
+  }
+
+  std::shared_ptr<Logger> log
+    = std::make_shared<Logger>("REPL", verbose);
+
+  if( scale < 1 ) {
+    printUsage();
+    return 1;
+  }
+
+  const bool isBookshelf = isAuxFile(fileName);
+  if( !outputPlFileName.empty() && !isBookshelf ) {
+    cout << "-output_pl requires a Bookshelf design" << endl;
+    return 1;
+  }
+
+  auto startTime = std::chrono::steady_clock::now();
+  BookshelfDesign design;
+  if( isBookshelf ) {
+    if( !readBookshelf(fileName, scale, design, log) ) {
+      return 1;
+    }
+    log->infoRuntime("BookshelfRead", getElapsed(startTime));
+  }
+  else {
+    if( !readSnapshot(fileName, design.data, log) ) {
+      return 1;
+    }
+    log->infoRuntime("SnapshotRead", getElapsed(startTime));
+  }
+
+  startTime = std::chrono::steady_clock::now();
+  std::shared_ptr<PlacerBase> pb
+    = std::make_shared<PlacerBase>(design.data, log);
+  log->infoRuntime("PlacerBaseInit", getElapsed(startTime));
+
+  // same defaults as Replace
+  int64_t ipMemoryBytes = 0;
+  if( !skipInitialPlace ) {
+    startTime = std::chrono::steady_clock::now();
+    InitialPlaceVars ipVars;
+    InitialPlace ip(ipVars, pb, log);
+    ip.doBicgstabPlace();
+    ipMemoryBytes = ip.memoryBytes();
+    log->infoRuntime("InitialPlace", getElapsed(startTime));
+  }
+
+  // same as Replace::doNesterovPlace
+  setLargeArrayOptions(hugePageMode, firstTouchMode, log);
+
+  startTime = std::chrono::steady_clock::now();
+  NesterovBaseVars nbVars;
+  nbVars.targetDensity = density;
+  nbVars.coarseFillerLevel = coarseFillerLevel;
+  std::shared_ptr<NesterovBase> nb
+    = std::make_shared<NesterovBase>(nbVars, pb, log);
+  log->infoRuntime("NesterovBaseInit", getElapsed(startTime));
+
+  startTime = std::chrono::steady_clock::now();
+  NesterovPlaceVars npVars;
+  npVars.targetOverflow = overflow;
+  npVars.metricsFile = metricsFileName;
+  npVars.localityOrder = localityOrder;
+  npVars.localityOrderInterval = localityOrderInterval;
+  NesterovPlace np(npVars, pb, nb, log);
+  np.doNesterovPlace();
+  log->infoRuntime("NesterovPlace", getElapsed(startTime));
+
+  log->infoInt64("FinalHPWL", pb->hpwl());
+
+  if( !outputPlFileName.empty() ) {
+    startTime = std::chrono::steady_clock::now();
+    if( !writeBookshelfPl(outputPlFileName, design, pb->toData(), log) ) {
+      return 1;
+    }
+    log->infoRuntime("BookshelfPlWrite", getElapsed(startTime));
+  }
+
+  log->reportProfile();
+
+  // same as Replace::reportMemory
+  log->infoMemory("PlacerBase", pb->memoryBytes());
+  log->infoMemory("NesterovBase", nb->memoryBytes());
+  log->infoMemory("BinGrid", nb->binGridMemoryBytes());
+  log->infoMemory("FFT", nb->fftMemoryBytes());
+  log->infoMemory("NesterovPlace", np.memoryBytes());
+  log->infoMemory("InitialPlace", ipMemoryBytes);
+  log->infoMemory("LargeArray", getLargeArrayBytes());
+  log->infoMemory("HugePage", getHugePageBytes());
+  log->infoMemory("PeakRss", Logger::getPeakRssBytes());
+  if( !profileJsonFileName.empty()
+      && !log->writeProfileJson(profileJsonFileName) ) {
+    log->warn("Cannot write profile: " + profileJsonFileName, 8);
+    return 1;
+  }
+  return 0;
+}
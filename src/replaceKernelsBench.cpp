@@ -0,0 +1,357 @@
+//
+// replace_kernels_bench : microbenchmarks of placer kernels
+// on deterministic synthetic inputs.
+//
+// Usage: replace_kernels_bench [-kernel name] [-reps val]
+//          [-max_cells val] [-output file]
+//
+//   kernel : all (default), fft, density, wa, initial_place
+//
+// A table is printed to stdout and, with -output,
+// one JSON object per case is written (JSON Lines),
+// so that the results can be tracked per commit.
+//
+
+#include "placerBase.h"
+#include "nesterovBase.h"
+#include "initialPlace.h"
+#include "fft.h"
+#include "syntheticDesign.h"
+#include "logger.h"
+#include "parallel.h"
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <cmath>
+#include <chrono>
+
+using namespace std;
+using namespace replace;
+
+// fixed seed; every run gets the same inputs.
+static const uint64_t benchSeed = 20200601;
+
+enum class DegreeDist {
+  // all nets are 2-pin nets
+  TwoPin,
+  // geometric; 3.5 pins on average
+  Geometric,
+  // Geometric + 1% of nets with 64-256 pins
+  HighFanout
+};
+
+static const char*
+getDegreeDistName(DegreeDist dist) {
+  switch(dist) {
+    case DegreeDist::TwoPin: return "two_pin";
+    case DegreeDist::Geometric: return "geometric";
+    case DegreeDist::HighFanout: return "high_fanout";
+  }
+  return "";
+}
+
+// Synthetic placement problem of syntheticDesign.h:
+// instCnt standard cells plus macroCnt movable macros
+// at random locations of a square core with 60% utilization.
+static PlacerBaseData
+getSyntheticData(int instCnt, int macroCnt, DegreeDist dist) {
+  SyntheticDesignVars vars;
+  vars.instCnt = instCnt;
+  vars.macroCnt = macroCnt;
+  vars.seed = benchSeed;
+  if( dist == DegreeDist::TwoPin ) {
+    vars.avgNetDegree = 2;
+  }
+  else if( dist == DegreeDist::HighFanout ) {
+    vars.highFanoutNetRatio = 0.01;
+  }
+
+  PlacerBaseData data;
+  getSyntheticDesign(vars, data);
+  return data;
+}
+
+////////////////////////////////////////////////////////
+// Timing and reporting
+
+class BenchResult {
+public:
+  string kernel;
+  string caseName;
+  int reps;
+  double minMs;
+  double medianMs;
+  double meanMs;
+};
+
+// setup runs before every rep (not timed).
+static BenchResult
+runBench(const string& kernel, const string& caseName, int reps,
+    const std::function<void()>& setup,
+    const std::function<void()>& func) {
+  // warm-up
+  setup();
+  func();
+
+  vector<double> times;
+  for(int i=0; i<reps; i++) {
+    setup();
+    auto startTime = std::chrono::steady_clock::now();
+    func();
+    times.push_back(std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - startTime).count());
+  }
+  sort(times.begin(), times.end());
+
+  BenchResult result;
+  result.kernel = kernel;
+  result.caseName = caseName;
+  result.reps = reps;
+  result.minMs = times.front();
+  result.medianMs = times[times.size() / 2];
+  result.meanMs = 0;
+  for(double time : times) {
+    result.meanMs += time;
+  }
+  result.meanMs /= times.size();
+
+  printf("%-16s %-40s %12.4f %12.4f %12.4f\n",
+      kernel.c_str(), caseName.c_str(),
+      result.minMs, result.medianMs, result.meanMs);
+  fflush(stdout);
+  return result;
+}
+
+static void
+writeResults(ostream& out, const vector<BenchResult>& results) {
+  const int threadCnt = getMaxThreads();
+
+  char buf[256];
+  for(auto& result : results) {
+    snprintf(buf, sizeof(buf),
+        "\"threads\": %d, \"reps\": %d, "
+        "\"min_ms\": %.6f, \"median_ms\": %.6f, \"mean_ms\": %.6f",
+        threadCnt, result.reps,
+        result.minMs, result.medianMs, result.meanMs);
+    out << "{\"kernel\": \"" << result.kernel << "\", "
+      << "\"case\": \"" << result.caseName << "\", "
+      << buf << "}\n";
+  }
+}
+
+////////////////////////////////////////////////////////
+// Kernels
+
+static void
+benchFFT(int reps, vector<BenchResult>& results) {
+  const int gridSizes[] = {64, 128, 256, 512, 1024};
+  for(int gridSize : gridSizes) {
+    FFT fft(gridSize, gridSize, 1000, 1000);
+    SyntheticRandom rand(benchSeed + gridSize);
+    vector<float> densities(gridSize * gridSize);
+    for(auto& density : densities) {
+      density = rand.nextDouble();
+    }
+
+    // doFFT overwrites its input
+    auto setup = [&]() {
+      for(int x=0; x<gridSize; x++) {
+        for(int y=0; y<gridSize; y++) {
+          fft.updateDensity(x, y, densities[x * gridSize + y]);
+        }
+      }
+    };
+    results.push_back(runBench("fft",
+          "grid=" + to_string(gridSize) + "x" + to_string(gridSize),
+          reps, setup, [&]() { fft.doFFT(); }));
+  }
+}
+
+static vector<int>
+getCellCnts(int maxCells) {
+  const int cellCnts[] = {10000, 100000, 1000000};
+  vector<int> cnts;
+  for(int cnt : cellCnts) {
+    if( cnt <= maxCells ) {
+      cnts.push_back(cnt);
+    }
+  }
+  return cnts;
+}
+
+// gCell density coordinates -> bins (incl. fillers)
+static void
+benchDensity(int reps, int maxCells,
+    std::shared_ptr<Logger> log,
+    vector<BenchResult>& results) {
+  for(int cellCnt : getCellCnts(maxCells)) {
+    // std cells only / 1% of area-heavy macros
+    const int macroCnts[] = {0, cellCnt / 1000};
+    for(int macroCnt : macroCnts) {
+      std::shared_ptr<PlacerBase> pb = std::make_shared<PlacerBase>(
+          getSyntheticData(cellCnt, macroCnt, DegreeDist::Geometric), log);
+      NesterovBaseVars nbVars;
+      nbVars.targetDensity = 0.7;
+      NesterovBase nb(nbVars, pb, log);
+
+      // same as NesterovPlace::init
+      FloatPointArray coordis;
+      for(auto& gCell : nb.gCells()) {
+        nb.updateDensityCoordiLayoutInside(gCell);
+        coordis.push_back(FloatPoint(gCell->dCx(), gCell->dCy()));
+      }
+
+      results.push_back(runBench("density",
+            "cells=" + to_string(cellCnt)
+            + ",macros=" + to_string(macroCnt)
+            + ",gcells=" + to_string(nb.gCells().size()),
+            reps, [](){},
+            [&]() { nb.updateGCellDensityCenterLocation(coordis); }));
+    }
+  }
+}
+
+static void
+benchWireLength(int reps, int maxCells,
+    std::shared_ptr<Logger> log,
+    vector<BenchResult>& results) {
+  const DegreeDist dists[]
+    = {DegreeDist::TwoPin, DegreeDist::Geometric, DegreeDist::HighFanout};
+  for(int cellCnt : getCellCnts(maxCells)) {
+    for(DegreeDist dist : dists) {
+      std::shared_ptr<PlacerBase> pb = std::make_shared<PlacerBase>(
+          getSyntheticData(cellCnt, 0, dist), log);
+      NesterovBaseVars nbVars;
+      nbVars.targetDensity = 0.7;
+      NesterovBase nb(nbVars, pb, log);
+
+      // NesterovPlace's coefficient at overflow 0.1 - 1.0
+      const float wlCoeff = 0.25 * 10
+        / ((nb.binSizeX() + nb.binSizeY()) * 0.5);
+
+      results.push_back(runBench("wa",
+            "cells=" + to_string(cellCnt) + ",degree="
+            + getDegreeDistName(dist)
+            + ",pins=" + to_string(nb.gPins().size()),
+            reps, [](){},
+            [&]() { nb.updateWireLengthForceWA(wlCoeff, wlCoeff); }));
+    }
+  }
+}
+
+// one B2B iteration: matrix assembly + X/Y solves
+static void
+benchInitialPlace(int reps, int maxCells,
+    std::shared_ptr<Logger> log,
+    vector<BenchResult>& results) {
+  for(int cellCnt : getCellCnts(maxCells)) {
+    std::shared_ptr<PlacerBase> pb = std::make_shared<PlacerBase>(
+        getSyntheticData(cellCnt, 0, DegreeDist::Geometric), log);
+
+    vector<pair<int, int>> locations;
+    for(auto& inst : pb->placeInsts()) {
+      locations.push_back(make_pair(inst->lx(), inst->ly()));
+    }
+
+    InitialPlaceVars ipVars;
+    ipVars.maxIter = 1;
+    ipVars.incrementalPlaceMode = true;
+
+    // start from the same locations on every rep
+    auto setup = [&]() {
+      for(size_t i=0; i<locations.size(); i++) {
+        pb->placeInsts()[i]->setLocation(
+            locations[i].first, locations[i].second);
+      }
+    };
+    results.push_back(runBench("initial_place",
+          "cells=" + to_string(cellCnt) + ",solver=bicgstab",
+          reps, setup, [&]() {
+            // mute per-iteration cout of InitialPlace
+            cout.setstate(ios::failbit);
+            InitialPlace ip(ipVars, pb, log);
+            ip.doBicgstabPlace();
+            cout.clear();
+          }));
+  }
+}
+
+static void
+printUsage() {
+  cout << "Usage: replace_kernels_bench [-kernel name] [-reps val]" << endl
+    << "         [-max_cells val] [-output file]" << endl
+    << "  kernel: all, fft, density, wa, initial_place" << endl;
+}
+
+int
+main(int argc, char* argv[]) {
+  string kernel = "all";
+  int reps = 5;
+  int maxCells = 100000;
+  string outputFileName;
+
+  for(int i=1; i<argc; i++) {
+    string arg = argv[i];
+    if( arg == "-kernel" && i+1 < argc ) {
+      kernel = argv[++i];
+    }
+    else if( arg == "-reps" && i+1 < argc ) {
+      reps = atoi(argv[++i]);
+    }
+    else if( arg == "-max_cells" && i+1 < argc ) {
+      maxCells = atoi(argv[++i]);
+    }
+    else if( arg == "-output" && i+1 < argc ) {
+      outputFileName = argv[++i];
+    }
+    else {
+      printUsage();
+      return 1;
+    }
+  }
+
+  if( reps < 1 || (kernel != "all" && kernel != "fft"
+        && kernel != "density" && kernel != "wa"
+        && kernel != "initial_place") ) {
+    printUsage();
+    return 1;
+  }
+
+  // placer messages would interleave with the table
+  std::shared_ptr<Logger> log
+    = std::make_shared<Logger>("REPL", -1);
+
+  printf("%-16s %-40s %12s %12s %12s\n",
+      "Kernel", "Case", "Min(ms)", "Median(ms)", "Mean(ms)");
+
+  vector<BenchResult> results;
+  if( kernel == "all" || kernel == "fft" ) {
+    benchFFT(reps, results);
+  }
+  if( kernel == "all" || kernel == "density" ) {
+    benchDensity(reps, maxCells, log, results);
+  }
+  if( kernel == "all" || kernel == "wa" ) {
+    benchWireLength(reps, maxCells, log, results);
+  }
+  if( kernel == "all" || kernel == "initial_place" ) {
+    benchInitialPlace(reps, maxCells, log, results);
+  }
+
+  if( !outputFileName.empty() ) {
+    ofstream out(outputFileName);
+    writeResults(out, results);
+    if( !out.good() ) {
+      cout << "Cannot write " << outputFileName << endl;
+      return 1;
+    }
+  }
+  return 0;
+}
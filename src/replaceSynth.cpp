@@ -0,0 +1,132 @@
+//
+// replace_synth : deterministic synthetic placement problems
+// (See syntheticDesign.h)
+//
+// Usage: replace_synth [-insts val] [-rent val] [-nets_per_inst val]
+//          [-avg_degree val] [-high_fanout_ratio val] [-macros val]
+//          [-blockage val] [-util val] [-fragmented_rows] [-ios val]
+//          [-seed val] [-snapshot file] [-bookshelf file.aux]
+//
+
+#include "placerBase.h"
+#include "syntheticDesign.h"
+#include "snapshot.h"
+#include "bookshelf.h"
+#include "logger.h"
+
+#include <iostream>
+#include <string>
+#include <cstdlib>
+#include <chrono>
+
+using namespace std;
+using namespace replace;
+
+static double
+getElapsed(std::chrono::steady_clock::time_point startTime) {
+  return std::chrono::duration<double>(
+      std::chrono::steady_clock::now() - startTime).count();
+}
+
+static void
+printUsage() {
+  cout << "Usage: replace_synth [-insts val] [-rent val]"
+    << " [-nets_per_inst val]" << endl
+    << "         [-avg_degree val] [-high_fanout_ratio val]"
+    << " [-macros val]" << endl
+    << "         [-blockage val] [-util val] [-fragmented_rows]"
+    << " [-ios val]" << endl
+    << "         [-seed val] [-snapshot file] [-bookshelf file.aux]"
+    << endl;
+}
+
+int
+main(int argc, char* argv[]) {
+  SyntheticDesignVars vars;
+  string snapshotFileName;
+  string bookshelfFileName;
+
+  for(int i=1; i<argc; i++) {
+    string arg = argv[i];
+    if( arg == "-insts" && i+1 < argc ) {
+      vars.instCnt = atoi(argv[++i]);
+    }
+    else if( arg == "-rent" && i+1 < argc ) {
+      vars.rentExponent = atof(argv[++i]);
+    }
+    else if( arg == "-nets_per_inst" && i+1 < argc ) {
+      vars.netsPerInst = atof(argv[++i]);
+    }
+    else if( arg == "-avg_degree" && i+1 < argc ) {
+      vars.avgNetDegree = atof(argv[++i]);
+    }
+    else if( arg == "-high_fanout_ratio" && i+1 < argc ) {
+      vars.highFanoutNetRatio = atof(argv[++i]);
+    }
+    else if( arg == "-macros" && i+1 < argc ) {
+      vars.macroCnt = atoi(argv[++i]);
+    }
+    else if( arg == "-blockage" && i+1 < argc ) {
+      vars.blockageRatio = atof(argv[++i]);
+    }
+    else if( arg == "-util" && i+1 < argc ) {
+      vars.utilization = atof(argv[++i]);
+    }
+    else if( arg == "-ios" && i+1 < argc ) {
+      vars.ioCnt = atoi(argv[++i]);
+    }
+    else if( arg == "-seed" && i+1 < argc ) {
+      vars.seed = strtoull(argv[++i], nullptr, 10);
+    }
+    else if( arg == "-snapshot" && i+1 < argc ) {
+      snapshotFileName = argv[++i];
+    }
+    else if( arg == "-bookshelf" && i+1 < argc ) {
+      bookshelfFileName = argv[++i];
+    }
+    else if( arg == "-fragmented_rows" ) {
+      vars.isFragmentedRow = true;
+    }
+    else {
+      printUsage();
+      return 1;
+    }
+  }
+
+  if( snapshotFileName.empty() && bookshelfFileName.empty() ) {
+    printUsage();
+    return 1;
+  }
+
+  if( vars.instCnt < 2
+      || vars.rentExponent <= 0 || vars.rentExponent >= 1
+      || vars.netsPerInst <= 0 || vars.avgNetDegree < 2
+      || vars.highFanoutNetRatio < 0 || vars.highFanoutNetRatio > 1
+      || vars.macroCnt < 0 || vars.ioCnt < 0
+      || vars.blockageRatio < 0 || vars.blockageRatio > 0.25
+      || vars.utilization <= 0 || vars.utilization > 1 ) {
+    cout << "Invalid synthetic design parameters" << endl;
+    return 1;
+  }
+
+  std::shared_ptr<Logger> log
+    = std::make_shared<Logger>("REPL", 0);
+
+  auto startTime = std::chrono::steady_clock::now();
+  PlacerBaseData data;
+  getSyntheticDesign(vars, data);
+  log->infoRuntime("SyntheticDesign", getElapsed(startTime));
+  log->infoInt("Instances", data.insts.size());
+  log->infoInt("Nets", data.netCnt);
+  log->infoInt("Pins", data.pins.size());
+
+  if( !snapshotFileName.empty()
+      && !writeSnapshot(snapshotFileName, data, log) ) {
+    return 1;
+  }
+  if( !bookshelfFileName.empty()
+      && !writeBookshelf(bookshelfFileName, data, log) ) {
+    return 1;
+  }
+  return 0;
+}
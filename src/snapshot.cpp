@@ -0,0 +1,238 @@
+#include "snapshot.h"
+#include "placerBase.h"
+#include "logger.h"
+
+#include <fstream>
+#include <cstring>
+#include <cstdint>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace replace {
+
+using namespace std;
+
+static const char snapshotMagic[8] = "RPLSNAP";
+
+// increase on every layout change
+static const uint32_t snapshotVersion = 1;
+
+// to detect files from the other byte order
+static const uint32_t snapshotByteOrderMark = 0x01020304;
+
+class SnapshotHeader {
+public:
+  char magic[8];
+  uint32_t version;
+  uint32_t byteOrderMark;
+  int32_t die[4];
+  int32_t core[4];
+  int32_t siteSizeX;
+  int32_t siteSizeY;
+  uint64_t instCnt;
+  uint64_t pinCnt;
+  uint64_t netCnt;
+  uint64_t rowCnt;
+};
+
+static_assert(sizeof(SnapshotHeader) % 8 == 0,
+    "SnapshotHeader must keep 8-byte alignment");
+static_assert(sizeof(PlacerBaseData::Box) == 4 * sizeof(int32_t),
+    "PlacerBaseData::Box must be 4 x int32");
+static_assert(sizeof(PlacerBaseData::PinData) == 4 * sizeof(int32_t),
+    "PlacerBaseData::PinData must be 4 x int32");
+
+static size_t
+getAlignedSize(size_t size) {
+  return (size + 7) / 8 * 8;
+}
+
+static void
+writePadding(ofstream& out, size_t size) {
+  static const char zeros[8] = {0};
+  out.write(zeros, getAlignedSize(size) - size);
+}
+
+static void
+setBox(int32_t* dst, const PlacerBaseData::Box& box) {
+  dst[0] = box.lx;
+  dst[1] = box.ly;
+  dst[2] = box.ux;
+  dst[3] = box.uy;
+}
+
+static PlacerBaseData::Box
+getBox(const int32_t* src) {
+  PlacerBaseData::Box box = {src[0], src[1], src[2], src[3]};
+  return box;
+}
+
+bool
+writeSnapshot(const string& fileName,
+    const PlacerBaseData& data,
+    std::shared_ptr<Logger> log) {
+  ofstream out(fileName, ios::binary);
+  if( !out.good() ) {
+    log->warn("Cannot open snapshot file: " + fileName, 6);
+    return false;
+  }
+
+  SnapshotHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+  header.version = snapshotVersion;
+  header.byteOrderMark = snapshotByteOrderMark;
+  setBox(header.die, data.die);
+  setBox(header.core, data.core);
+  header.siteSizeX = data.siteSizeX;
+  header.siteSizeY = data.siteSizeY;
+  header.instCnt = data.insts.size();
+  header.pinCnt = data.pins.size();
+  header.netCnt = data.netCnt;
+  header.rowCnt = data.rows.size();
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  // rows
+  const size_t rowsSize = sizeof(PlacerBaseData::Box) * data.rows.size();
+  out.write(reinterpret_cast<const char*>(data.rows.data()), rowsSize);
+  writePadding(out, rowsSize);
+
+  // insts
+  for(auto& inst : data.insts) {
+    int32_t box[4];
+    setBox(box, inst.box);
+    out.write(reinterpret_cast<const char*>(box), sizeof(box));
+  }
+
+  // instFlags
+  std::vector<uint8_t> instFlags(data.insts.size(), 0);
+  for(size_t i=0; i<data.insts.size(); i++) {
+    instFlags[i] = (data.insts[i].isFixed)? 1 : 0;
+  }
+  out.write(reinterpret_cast<const char*>(instFlags.data()),
+      instFlags.size());
+  writePadding(out, instFlags.size());
+
+  // pins
+  out.write(reinterpret_cast<const char*>(data.pins.data()),
+      sizeof(PlacerBaseData::PinData) * data.pins.size());
+
+  if( !out.good() ) {
+    log->warn("Failed to write snapshot file: " + fileName, 6);
+    return false;
+  }
+
+  log->infoString("SnapshotWritten", fileName);
+  return true;
+}
+
+// parse the memory-mapped snapshot on buf
+static bool
+readSnapshot(const char* buf, size_t bufSize,
+    PlacerBaseData& data,
+    std::shared_ptr<Logger> log) {
+  SnapshotHeader header;
+  memcpy(&header, buf, sizeof(header));
+
+  if( memcmp(header.magic, snapshotMagic, sizeof(header.magic)) != 0 ) {
+    log->warn("Not a snapshot file", 6);
+    return false;
+  }
+  if( header.byteOrderMark != snapshotByteOrderMark ) {
+    log->warn("Snapshot byte order mismatch", 6);
+    return false;
+  }
+  if( header.version != snapshotVersion ) {
+    log->warn("Snapshot version mismatch: "
+        + to_string(header.version) + " (expected: "
+        + to_string(snapshotVersion) + ")", 6);
+    return false;
+  }
+
+  const size_t rowsOffset = sizeof(header);
+  const size_t instsOffset = rowsOffset
+    + getAlignedSize(sizeof(int32_t) * 4 * header.rowCnt);
+  const size_t instFlagsOffset = instsOffset
+    + getAlignedSize(sizeof(int32_t) * 4 * header.instCnt);
+  const size_t pinsOffset = instFlagsOffset
+    + getAlignedSize(header.instCnt);
+  const size_t endOffset = pinsOffset
+    + sizeof(int32_t) * 4 * header.pinCnt;
+
+  if( bufSize < endOffset ) {
+    log->warn("Snapshot file is truncated", 6);
+    return false;
+  }
+
+  data.die = getBox(header.die);
+  data.core = getBox(header.core);
+  data.siteSizeX = header.siteSizeX;
+  data.siteSizeY = header.siteSizeY;
+  data.netCnt = header.netCnt;
+
+  const PlacerBaseData::Box* rows
+    = reinterpret_cast<const PlacerBaseData::Box*>(buf + rowsOffset);
+  data.rows.assign(rows, rows + header.rowCnt);
+
+  const int32_t* instBoxes
+    = reinterpret_cast<const int32_t*>(buf + instsOffset);
+  const uint8_t* instFlags
+    = reinterpret_cast<const uint8_t*>(buf + instFlagsOffset);
+  data.insts.resize(header.instCnt);
+  for(size_t i=0; i<header.instCnt; i++) {
+    data.insts[i].box = getBox(instBoxes + 4*i);
+    data.insts[i].isFixed = (instFlags[i] & 1);
+  }
+
+  const PlacerBaseData::PinData* pins
+    = reinterpret_cast<const PlacerBaseData::PinData*>(buf + pinsOffset);
+  data.pins.assign(pins, pins + header.pinCnt);
+
+  // reject broken references before building PlacerBase
+  const int instCnt = data.insts.size();
+  for(auto& pin : data.pins) {
+    if( pin.inst < -1 || pin.inst >= instCnt ||
+        pin.net < 0 || pin.net >= data.netCnt ) {
+      log->warn("Snapshot has invalid pin references", 6);
+      return false;
+    }
+  }
+  return true;
+}
+
+bool
+readSnapshot(const string& fileName,
+    PlacerBaseData& data,
+    std::shared_ptr<Logger> log) {
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if( fd < 0 ) {
+    log->warn("Cannot open snapshot file: " + fileName, 6);
+    return false;
+  }
+
+  struct stat fileStat;
+  if( fstat(fd, &fileStat) != 0
+      || static_cast<size_t>(fileStat.st_size) < sizeof(SnapshotHeader) ) {
+    close(fd);
+    log->warn("Not a snapshot file: " + fileName, 6);
+    return false;
+  }
+
+  const size_t fileSize = fileStat.st_size;
+  void* buf = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if( buf == MAP_FAILED ) {
+    log->warn("Cannot map snapshot file: " + fileName, 6);
+    return false;
+  }
+
+  bool isRead = readSnapshot(static_cast<const char*>(buf), fileSize,
+      data, log);
+  munmap(buf, fileSize);
+  return isRead;
+}
+
+}
@@ -0,0 +1,42 @@
+#ifndef __REPLACE_SNAPSHOT__
+#define __REPLACE_SNAPSHOT__
+
+#include <string>
+#include <memory>
+
+namespace replace {
+
+class PlacerBaseData;
+class Logger;
+
+//
+// Binary snapshot of PlacerBaseData
+// for standalone placer runs (e.g. replace_bench) and bug reports.
+//
+// Layout (native byte order).
+// Every section starts on 8-byte boundary,
+// so that the file can be memory-mapped.
+//
+//   header    : magic "RPLSNAP", version, byte order mark,
+//               die/core box, site size,
+//               instCnt, pinCnt, netCnt, rowCnt
+//   rows      : int32[rowCnt * 4]  (lx, ly, ux, uy)
+//   insts     : int32[instCnt * 4] (lx, ly, ux, uy)
+//   instFlags : uint8[instCnt]     (bit0 : fixed)
+//   pins      : int32[pinCnt * 4]  (inst, net, x, y)
+//
+// (See PlacerBaseData for the meaning of each field)
+//
+// Both return false on I/O or format errors.
+//
+bool writeSnapshot(const std::string& fileName,
+    const PlacerBaseData& data,
+    std::shared_ptr<Logger> log);
+
+bool readSnapshot(const std::string& fileName,
+    PlacerBaseData& data,
+    std::shared_ptr<Logger> log);
+
+}
+
+#endif
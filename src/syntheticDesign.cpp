@@ -0,0 +1,349 @@
+#include "syntheticDesign.h"
+#include "placerBase.h"
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+namespace replace {
+
+using namespace std;
+
+// nangate45-like geometry in DBU
+static const int siteSizeX = 380;
+static const int siteSizeY = 2800;
+
+SyntheticDesignVars::SyntheticDesignVars()
+  : instCnt(100000),
+  rentExponent(0.6),
+  netsPerInst(1.0),
+  avgNetDegree(3.5),
+  highFanoutNetRatio(0),
+  macroCnt(0),
+  blockageRatio(0),
+  utilization(0.6),
+  isFragmentedRow(false),
+  ioCnt(0),
+  seed(1) {}
+
+static int
+getNetDegree(const SyntheticDesignVars& vars, SyntheticRandom& rand) {
+  if( vars.highFanoutNetRatio > 0
+      && rand.nextDouble() < vars.highFanoutNetRatio ) {
+    return 64 + rand.nextInt(193);
+  }
+  if( vars.avgNetDegree <= 2 ) {
+    return 2;
+  }
+
+  // 2 + geometric; mean is avgNetDegree
+  const double prob = (vars.avgNetDegree - 2) / (vars.avgNetDegree - 1);
+  int degree = 2;
+  while( degree < 32 && rand.nextDouble() < prob ) {
+    degree++;
+  }
+  return degree;
+}
+
+static PlacerBaseData::Box
+getBox(int lx, int ly, int ux, int uy) {
+  PlacerBaseData::Box box = {lx, ly, ux, uy};
+  return box;
+}
+
+static int
+snapDown(int val, int grid) {
+  return val / grid * grid;
+}
+
+// movable cells at random locations of the core
+static void
+addInsts(const vector<int>& widths, const vector<int>& heights,
+    const PlacerBaseData::Box& core,
+    SyntheticRandom& rand, PlacerBaseData& data) {
+  for(size_t i=0; i<widths.size(); i++) {
+    PlacerBaseData::InstData inst;
+    const int lx = core.lx + rand.nextInt(
+        max(1, core.ux - core.lx - widths[i]));
+    const int ly = core.ly + rand.nextInt(
+        max(1, core.uy - core.ly - heights[i]));
+    inst.box = getBox(lx, ly, lx + widths[i], ly + heights[i]);
+    inst.isFixed = false;
+    data.insts.push_back(inst);
+  }
+}
+
+// fixed square blockages in 4 distinct tiles of a 4x4 grid
+static void
+addBlockages(float blockageRatio,
+    const PlacerBaseData::Box& core,
+    SyntheticRandom& rand, PlacerBaseData& data) {
+  const int blockageCnt = 4;
+  const int tileCnt = 4;
+  const double coreArea = static_cast<double>(core.ux - core.lx)
+    * (core.uy - core.ly);
+  const int tileSizeX = (core.ux - core.lx) / tileCnt;
+  const int tileSizeY = (core.uy - core.ly) / tileCnt;
+  const int blockageSize = min(min(tileSizeX, tileSizeY),
+      static_cast<int>(sqrt(coreArea * blockageRatio / blockageCnt)));
+
+  vector<int> tiles(tileCnt * tileCnt);
+  for(size_t i=0; i<tiles.size(); i++) {
+    tiles[i] = i;
+  }
+  for(int i=tiles.size()-1; i>0; i--) {
+    swap(tiles[i], tiles[rand.nextInt(i+1)]);
+  }
+
+  for(int i=0; i<blockageCnt; i++) {
+    const int tileX = tiles[i] % tileCnt;
+    const int tileY = tiles[i] / tileCnt;
+    const int lx = core.lx + snapDown(tileX * tileSizeX
+        + (tileSizeX - blockageSize) / 2, siteSizeX);
+    const int ly = core.ly + snapDown(tileY * tileSizeY
+        + (tileSizeY - blockageSize) / 2, siteSizeY);
+
+    PlacerBaseData::InstData inst;
+    inst.box = getBox(lx, ly, lx + blockageSize, ly + blockageSize);
+    inst.isFixed = true;
+    data.insts.push_back(inst);
+  }
+}
+
+static void
+addRows(bool isFragmentedRow,
+    const PlacerBaseData::Box& core,
+    SyntheticRandom& rand, PlacerBaseData& data) {
+  const int64_t coreWidth = core.ux - core.lx;
+  for(int ly = core.ly; ly + siteSizeY <= core.uy; ly += siteSizeY) {
+    if( !isFragmentedRow ) {
+      data.rows.push_back(getBox(core.lx, ly, core.ux, ly + siteSizeY));
+      continue;
+    }
+
+    // 1 - 3 gaps of 2 - 8% of the core width,
+    // evenly spread with 5% jitter
+    int lx = core.lx;
+    const int gapCnt = 1 + rand.nextInt(3);
+    for(int i=0; i<gapCnt; i++) {
+      const int gapCenter = coreWidth * (i+1) / (gapCnt+1)
+        - coreWidth / 20 + rand.nextInt(coreWidth / 10 + 1);
+      const int gapWidth = max(siteSizeX, snapDown(
+            static_cast<int>(coreWidth * (2 + rand.nextInt(7)) / 100),
+            siteSizeX));
+      const int gapLx = core.lx + snapDown(gapCenter - gapWidth / 2, siteSizeX);
+      if( gapLx <= lx || gapLx + gapWidth >= core.ux ) {
+        continue;
+      }
+      data.rows.push_back(getBox(lx, ly, gapLx, ly + siteSizeY));
+      lx = gapLx + gapWidth;
+    }
+    data.rows.push_back(getBox(lx, ly, core.ux, ly + siteSizeY));
+  }
+}
+
+static void
+addPin(int inst, int net, const PlacerBaseData& data,
+    SyntheticRandom& rand, vector<PlacerBaseData::PinData>& pins) {
+  const PlacerBaseData::Box& box = data.insts[inst].box;
+  const int width = box.ux - box.lx;
+  const int height = box.uy - box.ly;
+
+  PlacerBaseData::PinData pin;
+  pin.inst = inst;
+  pin.net = net;
+  pin.x = rand.nextInt(width) - width / 2;
+  pin.y = rand.nextInt(height) - height / 2;
+  pins.push_back(pin);
+}
+
+// pick a cell in [begin, end) that is not in [netBegin, pins.end())
+static int
+getNetInst(int begin, int end,
+    const vector<PlacerBaseData::PinData>& pins, size_t netBegin,
+    SyntheticRandom& rand) {
+  int inst = begin + rand.nextInt(end - begin);
+  for(int retry=0; retry<4; retry++) {
+    bool isDuplicated = false;
+    for(size_t i=netBegin; i<pins.size(); i++) {
+      if( pins[i].inst == inst ) {
+        isDuplicated = true;
+        break;
+      }
+    }
+    if( !isDuplicated ) {
+      break;
+    }
+    inst = begin + rand.nextInt(end - begin);
+  }
+  return inst;
+}
+
+// Rent's rule on a binary hierarchy of cells [0, instCnt).
+//
+// Two sibling blocks of g cells have 2 * t * g^p terminals,
+// their parent has t * (2g)^p, so
+//   t * g^p * (2 - 2^p) / 2
+// nets connect the siblings. Nets are split over the levels
+// in that proportion, and a level-k net has pins in both
+// 2^k-cell halves of its block.
+static void
+addNets(const SyntheticDesignVars& vars,
+    SyntheticRandom& rand, PlacerBaseData& data) {
+  const int instCnt = vars.instCnt;
+  const double rent = vars.rentExponent;
+  data.netCnt = max(1, static_cast<int>(
+        llround(vars.netsPerInst * instCnt)));
+
+  // child block size per level
+  vector<int64_t> childSizes;
+  vector<double> weights;
+  double weightSum = 0;
+  for(int64_t childSize = 1; childSize < instCnt; childSize *= 2) {
+    const int64_t blockCnt = (instCnt + 2 * childSize - 1) / (2 * childSize);
+    const double weight = blockCnt * pow(childSize, rent)
+      * (2 - pow(2, rent)) / 2;
+    childSizes.push_back(childSize);
+    weights.push_back(weight);
+    weightSum += weight;
+  }
+  if( childSizes.empty() ) {
+    childSizes.push_back(1);
+    weights.push_back(1);
+    weightSum = 1;
+  }
+
+  // level of each net; remainders go to the bottom level
+  vector<int> levelNetCnts(childSizes.size());
+  int assignedNetCnt = 0;
+  for(size_t k=0; k<childSizes.size(); k++) {
+    levelNetCnts[k] = static_cast<int>(data.netCnt * weights[k] / weightSum);
+    assignedNetCnt += levelNetCnts[k];
+  }
+  levelNetCnts[0] += data.netCnt - assignedNetCnt;
+
+  data.pins.reserve(static_cast<size_t>(data.netCnt * vars.avgNetDegree));
+  int net = 0;
+  for(size_t k=0; k<childSizes.size(); k++) {
+    const int64_t childSize = childSizes[k];
+    const int blockCnt = (instCnt + 2 * childSize - 1) / (2 * childSize);
+
+    for(int i=0; i<levelNetCnts[k]; i++, net++) {
+      const size_t netBegin = data.pins.size();
+      int degree = getNetDegree(vars, rand);
+
+      int begin = 0, mid = 0, end = instCnt;
+      // high fanout nets span the whole design
+      if( degree < 64 ) {
+        const int block = rand.nextInt(blockCnt);
+        begin = block * 2 * childSize;
+        end = min(static_cast<int64_t>(instCnt), begin + 2 * childSize);
+        mid = min(static_cast<int64_t>(end), begin + childSize);
+      }
+      degree = min(degree, end - begin);
+
+      // one pin on each half
+      if( mid > begin && mid < end ) {
+        addPin(getNetInst(begin, mid, data.pins, netBegin, rand),
+            net, data, rand, data.pins);
+        addPin(getNetInst(mid, end, data.pins, netBegin, rand),
+            net, data, rand, data.pins);
+      }
+      while( static_cast<int>(data.pins.size() - netBegin) < degree ) {
+        addPin(getNetInst(begin, end, data.pins, netBegin, rand),
+            net, data, rand, data.pins);
+      }
+    }
+  }
+
+  // macros join 32 random nets each
+  for(int i=0; i<vars.macroCnt; i++) {
+    for(int j=0; j<32; j++) {
+      addPin(instCnt + i, rand.nextInt(data.netCnt), data, rand, data.pins);
+    }
+  }
+}
+
+// IO pins on the core boundary, each on a random net
+static void
+addIos(int ioCnt, SyntheticRandom& rand, PlacerBaseData& data) {
+  const PlacerBaseData::Box& core = data.core;
+  const int64_t width = core.ux - core.lx;
+  const int64_t height = core.uy - core.ly;
+  const int64_t perimeter = 2 * (width + height);
+
+  for(int i=0; i<ioCnt; i++) {
+    int64_t pos = perimeter * i / ioCnt;
+    PlacerBaseData::PinData pin;
+    pin.inst = -1;
+    pin.net = rand.nextInt(data.netCnt);
+    if( pos < width ) {
+      pin.x = core.lx + pos;
+      pin.y = core.ly;
+    }
+    else if( (pos -= width) < height ) {
+      pin.x = core.ux;
+      pin.y = core.ly + pos;
+    }
+    else if( (pos -= height) < width ) {
+      pin.x = core.ux - pos;
+      pin.y = core.uy;
+    }
+    else {
+      pos -= width;
+      pin.x = core.lx;
+      pin.y = core.uy - pos;
+    }
+    data.pins.push_back(pin);
+  }
+}
+
+void
+getSyntheticDesign(const SyntheticDesignVars& vars,
+    PlacerBaseData& data) {
+  SyntheticRandom rand(vars.seed);
+  data = PlacerBaseData();
+  data.siteSizeX = siteSizeX;
+  data.siteSizeY = siteSizeY;
+
+  // std cells: 1 - 8 sites, macros: 40 - 120 sites x 8 - 24 rows
+  const int instCnt = max(1, vars.instCnt);
+  vector<int> widths, heights;
+  widths.reserve(instCnt + vars.macroCnt);
+  heights.reserve(instCnt + vars.macroCnt);
+  double movableArea = 0;
+  for(int i=0; i<instCnt + vars.macroCnt; i++) {
+    const bool isMacro = (i >= instCnt);
+    widths.push_back(siteSizeX * ((isMacro)?
+          40 + rand.nextInt(81) : 1 + rand.nextInt(8)));
+    heights.push_back(siteSizeY * ((isMacro)? 8 + rand.nextInt(17) : 1));
+    movableArea += static_cast<double>(widths.back()) * heights.back();
+  }
+
+  // square core
+  const float blockageRatio = min(0.25f, max(0.0f, vars.blockageRatio));
+  const double coreArea = movableArea
+    / max(0.01f, vars.utilization) / (1 - blockageRatio);
+  const int rowCnt = max(1, static_cast<int>(ceil(sqrt(coreArea) / siteSizeY)));
+  const int coreSize = rowCnt * siteSizeY;
+  data.core = getBox(0, 0, snapDown(coreSize, siteSizeX), coreSize);
+
+  // room for IO ring
+  const int ioMargin = (vars.ioCnt > 0)? 4 * siteSizeY : 0;
+  data.die = getBox(data.core.lx - ioMargin, data.core.ly - ioMargin,
+      data.core.ux + ioMargin, data.core.uy + ioMargin);
+
+  addRows(vars.isFragmentedRow, data.core, rand, data);
+
+  SyntheticDesignVars netVars = vars;
+  netVars.instCnt = instCnt;
+  data.insts.reserve(instCnt + vars.macroCnt + 4);
+  addInsts(widths, heights, data.core, rand, data);
+  if( blockageRatio > 0 ) {
+    addBlockages(blockageRatio, data.core, rand, data);
+  }
+  addNets(netVars, rand, data);
+  addIos(vars.ioCnt, rand, data);
+}
+
+}
@@ -0,0 +1,85 @@
+#ifndef __REPLACE_SYNTHETIC_DESIGN__
+#define __REPLACE_SYNTHETIC_DESIGN__
+
+#include <cstdint>
+
+namespace replace {
+
+class PlacerBaseData;
+
+// splitmix64 for the synthetic design and benchmark inputs.
+// std:: distributions differ between standard libraries,
+// so everything is derived from raw integers.
+class SyntheticRandom {
+public:
+  SyntheticRandom(uint64_t seed) : state_(seed) {}
+
+  uint64_t next() {
+    uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+  // [0, n)
+  int nextInt(int n) {
+    return (n <= 1)? 0 : static_cast<int>(next() % n);
+  }
+
+  // [0, 1)
+  double nextDouble() {
+    return (next() >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+private:
+  uint64_t state_;
+};
+
+class SyntheticDesignVars {
+public:
+  // standard cells
+  int instCnt;
+
+  // Rent exponent p (0 < p < 1).
+  // The cells are the leaves of a binary hierarchy, and a block of
+  // g cells has ~ t * g^p external terminals (Rent's rule).
+  // Larger p gives more nets spanning large blocks (longer nets).
+  float rentExponent;
+
+  // nets per standard cell
+  float netsPerInst;
+
+  // average net degree (>= 2); 2 gives two-pin nets only.
+  float avgNetDegree;
+
+  // fraction of nets with 64 - 256 pins
+  float highFanoutNetRatio;
+
+  // movable macros, connected to random nets
+  int macroCnt;
+
+  // fixed blockage area over core area [0 - 0.25]
+  float blockageRatio;
+
+  // movable area over free core area
+  float utilization;
+
+  // cut every row into 2 - 4 sub-rows
+  bool isFragmentedRow;
+
+  // IO pins evenly spread on the core boundary
+  int ioCnt;
+
+  uint64_t seed;
+
+  SyntheticDesignVars();
+};
+
+// Fill data with a placement problem built from vars.
+// Same vars always give the same data.
+void getSyntheticDesign(const SyntheticDesignVars& vars,
+    PlacerBaseData& data);
+
+}
+
+#endif
@@ -7,6 +7,9 @@ record_tests {
   ar01 
   ar02 
   incremental01
+  filler01
+  locality01
+  b2b01
 }
 
 # commented out at this moment..